@@ -10,6 +10,7 @@ For conditions of distribution and use, see LICENSE file
 #include <cstdint>
 #include <cstddef>
 #include "drivers/SSD1306/SSD1306.hpp"
+#include "transport.hpp"
 
 namespace util {
 namespace SSD1306 {
@@ -89,7 +90,75 @@ struct display {
     sendData(data, length);
   }
 
+  /**
+   * @brief Initializes the display over a transport, addressing the display is up to the transport
+   *
+   * @tparam transportType  transport of uint8_t elements, see transport.hpp
+   * @param bus             transport to the display
+   * @param initCommands    commands, must stay valid until the transport is not busy
+   * @param initCommandLength amount of command bytes
+   */
+  template <typename transportType>
+    requires transport<transportType, uint8_t>
+  void init(transportType &bus, const uint8_t *initCommands, uint16_t initCommandLength) {
+    sendCommands(bus, initCommands, initCommandLength);
+  }
+
+  /**
+   * @brief Sends commands as one transaction, the command prefix is sent as a separate segment
+   *
+   * @tparam transportType  transport of uint8_t elements, see transport.hpp
+   * @param bus             transport to the display
+   * @param data            commands, must stay valid until the transport is not busy
+   * @param length          amount of command bytes
+   * @return result         result of the transport
+   */
+  template <typename transportType>
+    requires transport<transportType, uint8_t>
+  result sendCommands(transportType &bus, const uint8_t *data, uint16_t length) {
+    const transferSegment<uint8_t> segments[] = {{&commandPrefix, 1}, {data, length}};
+    return bus.transfer(segments);
+  }
+
+  /**
+   * @brief Sends display data as one transaction, the data prefix is sent as a separate segment
+   *
+   * @tparam transportType  transport of uint8_t elements, see transport.hpp
+   * @param bus             transport to the display
+   * @param data            display data, must stay valid until the transport is not busy
+   * @param length          amount of data bytes
+   * @return result         result of the transport
+   */
+  template <typename transportType>
+    requires transport<transportType, uint8_t>
+  result sendData(transportType &bus, const uint8_t *data, uint16_t length) {
+    const transferSegment<uint8_t> segments[] = {{&dataPrefix, 1}, {data, length}};
+    return bus.transfer(segments);
+  }
+
+  /**
+   * @brief Writes data to a window of the display over a transport
+   *
+   * @tparam transportType  transport of uint8_t elements, see transport.hpp
+   * @param bus             transport to the display
+   * @param data            display data, must stay valid until the transport is not busy
+   * @param length          amount of data bytes
+   */
+  template <typename transportType>
+    requires transport<transportType, uint8_t>
+  void writeWindow(transportType &bus, uint8_t xBegin, uint8_t xEnd, uint8_t yBegin, uint8_t yEnd, const uint8_t *data,
+                   uint16_t length) {
+    const uint8_t setPointer[] = {
+      SSD1306::setPageAddress, (uint8_t)(yBegin >> 3), (uint8_t)(yEnd >> 3), SSD1306::setColumnAddress, xBegin, xEnd};
+    sendCommands(bus, setPointer, sizeof(setPointer));
+    // the next transfer waits for the previous one, so setPointer stays valid while it is sent
+    sendData(bus, data, length);
+  }
+
   void update() {}
+
+  static constexpr uint8_t commandPrefix = 0x00; /**< control byte preceding commands */
+  static constexpr uint8_t dataPrefix = 0x40;    /**< control byte preceding display data */
 };
 
 }  // namespace SSD1306
@@ -11,6 +11,9 @@ For conditions of distribution and use, see LICENSE file
 #include <cstddef>
 #include "drivers/SSD1306/SSD1306.hpp"
 #include "array.hpp"
+#include "bit/fill.hpp"
+#include "bit/bitblitoriented.hpp"
+#include "transport.hpp"
 
 namespace util {
 namespace SSD1306 {
@@ -101,13 +104,94 @@ struct display {
     sendData(frameBuffer.data(), frameBuffer.size());
   }
 
+  /**
+   * @brief Initializes the display over a transport, addressing the display is up to the transport
+   *
+   * @tparam transportType  transport of uint8_t elements, see transport.hpp
+   * @param bus             transport to the display
+   */
+  template <typename transportType>
+    requires transport<transportType, uint8_t>
+  void init(transportType &bus) {
+    sendCommands(bus, config::init, config::initLength);
+  }
+
+  /**
+   * @brief Sends commands as one transaction, the command prefix is sent as a separate segment
+   *
+   * @tparam transportType  transport of uint8_t elements, see transport.hpp
+   * @param bus             transport to the display
+   * @param data            commands, must stay valid until the transport is not busy
+   * @param length          amount of command bytes
+   * @return result         result of the transport
+   */
+  template <typename transportType>
+    requires transport<transportType, uint8_t>
+  result sendCommands(transportType &bus, const uint8_t *data, uint16_t length) {
+    const transferSegment<uint8_t> segments[] = {{&commandPrefix, 1}, {data, length}};
+    return bus.transfer(segments);
+  }
+
+  /**
+   * @brief Sends display data as one transaction, the data prefix is sent as a separate segment
+   *
+   * @tparam transportType  transport of uint8_t elements, see transport.hpp
+   * @param bus             transport to the display
+   * @param data            display data, must stay valid until the transport is not busy
+   * @param length          amount of data bytes
+   * @return result         result of the transport
+   */
+  template <typename transportType>
+    requires transport<transportType, uint8_t>
+  result sendData(transportType &bus, const uint8_t *data, uint16_t length) {
+    const transferSegment<uint8_t> segments[] = {{&dataPrefix, 1}, {data, length}};
+    return bus.transfer(segments);
+  }
+
+  /**
+   * @brief Sends the framebuffer over a transport without copying, the framebuffer must not be changed while the
+   * transport is busy
+   *
+   * @tparam transportType  transport of uint8_t elements, see transport.hpp
+   * @param bus             transport to the display
+   */
+  template <typename transportType>
+    requires transport<transportType, uint8_t>
+  void update(transportType &bus) {
+    static const uint8_t setPointer[] = {SSD1306::setPageAddress, 0, (maxY - 1) >> 3, SSD1306::setColumnAddress, 0, maxX - 1};
+    sendCommands(bus, setPointer, sizeof(setPointer));
+    sendData(bus, frameBuffer.data(), frameBuffer.size());
+  }
+
   void clear(uint8_t clearColor) {
     for (uint8_t &data : frameBuffer) data = clearColor;
   }
 
+  // block is a row oriented bitmap, it is rotated or mirrored while transferring into the page oriented framebuffer
+  void bitBlockTransfer(int xPos, int yPos, const uint8_t *block, unsigned int blockWidth, unsigned int blockHeight,
+                        bitblitOrientation orientation, bitblitOperation op) {
+    bitblit2dpaged(frameBuffer.data(), maxX, maxY, xPos, yPos, block, blockWidth, blockHeight, orientation, op);
+  }
+
+  void fillRect(int x, int y, unsigned int width, unsigned int height, bool set) {
+    fillRectPaged(frameBuffer.data(), maxX, maxY, x, y, width, height, set);
+  }
+
+  void invertRect(int x, int y, unsigned int width, unsigned int height) {
+    invertRectPaged(frameBuffer.data(), maxX, maxY, x, y, width, height);
+  }
+
+  // pattern contains one byte per pattern column, every byte contains 8 vertical pixels
+  void patternFill(int x, int y, unsigned int width, unsigned int height, const uint8_t *pattern, unsigned int patternWidth,
+                   bitblitOperation op) {
+    patternFillPaged(frameBuffer.data(), maxX, maxY, x, y, width, height, pattern, patternWidth, op);
+  }
+
   array<uint8_t, ((config::maxY) / 8) * (config::maxX)> frameBuffer;
   static const uint8_t maxX = config::maxX;
   static const uint8_t maxY = config::maxY;
+  static constexpr uint8_t commandPrefix = 0x00; /**< control byte preceding commands */
+  static constexpr uint8_t dataPrefix = 0x40;    /**< control byte preceding display data */
 };
 
 }  // namespace SSD1306
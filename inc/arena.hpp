@@ -0,0 +1,201 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file arena.hpp
+ *
+ * Monotonic arena allocator for short lived scratch memory
+ *
+ */
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <array.hpp>
+
+namespace util {
+
+/**
+ * @brief Bump pointer allocator over caller provided storage
+ *
+ * Allocations are only released all at once, by rewinding to a checkpoint or resetting the arena. Destructors of objects
+ * created in the arena are never called.
+ */
+class arena {
+ public:
+  /**
+   * @brief Position in the arena to rewind to, obtained from checkpoint
+   *
+   */
+  using checkpointType = size_t;
+
+  /**
+   * @brief Creates an arena using an array as storage, the array must outlive the arena
+   *
+   * @tparam N        size of the storage in bytes
+   * @param storage   storage to allocate from
+   */
+  template <size_t N>
+  explicit arena(array<uint8_t, N> &storage) noexcept : storageBegin{storage.data()}, storageSize{N} {}
+
+  arena(const arena &) = delete;
+  arena &operator=(const arena &) = delete;
+
+  /**
+   * @brief Allocates memory from the arena
+   *
+   * @param bytes     amount of bytes to allocate
+   * @param alignment alignment of the allocation, power of two
+   * @return void*    allocated memory, nullptr when the arena has no room left
+   */
+  void *allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) noexcept {
+    const uintptr_t base = reinterpret_cast<uintptr_t>(storageBegin);
+    const uintptr_t aligned = (base + offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    const size_t start = static_cast<size_t>(aligned - base);
+    if ((start > storageSize) || (bytes > storageSize - start)) return nullptr;
+    offset = start + bytes;
+    if (offset > highWater) highWater = offset;
+    return storageBegin + start;
+  }
+
+  /**
+   * @brief Allocates and constructs an object in the arena
+   *
+   * @tparam T      type of the object, must be trivially destructible as it is never destroyed
+   * @tparam Args   constructor argument types
+   * @param args    constructor arguments
+   * @return T*     constructed object, nullptr when the arena has no room left
+   */
+  template <typename T, typename... Args>
+  T *create(Args &&...args) {
+    static_assert(std::is_trivially_destructible_v<T>, "arena objects are never destroyed");
+    void *memory = allocate(sizeof(T), alignof(T));
+    if (memory == nullptr) return nullptr;
+    return new (memory) T(std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Allocates an uninitialized array of objects in the arena
+   *
+   * @tparam T      element type, must be trivially destructible as it is never destroyed
+   * @param count   amount of elements
+   * @return T*     first element, nullptr when the arena has no room left
+   */
+  template <typename T>
+  T *allocateArray(size_t count) noexcept {
+    static_assert(std::is_trivially_destructible_v<T>, "arena objects are never destroyed");
+    if (count > storageSize / sizeof(T)) return nullptr;
+    return static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+  }
+
+  /**
+   * @brief Marks the current position of the arena
+   *
+   * @return checkpointType position to pass to rewind
+   */
+  checkpointType checkpoint() const noexcept {
+    return offset;
+  }
+
+  /**
+   * @brief Releases all allocations made after a checkpoint
+   *
+   * @param position checkpoint to return to
+   */
+  void rewind(checkpointType position) noexcept {
+    if (position < offset) offset = position;
+  }
+
+  /**
+   * @brief Releases all allocations
+   *
+   */
+  void reset() noexcept {
+    offset = 0;
+  }
+
+  /**
+   * @brief Amount of bytes in use, including alignment padding
+   *
+   * @return size_t bytes in use
+   */
+  size_t used() const noexcept {
+    return offset;
+  }
+
+  /**
+   * @brief Amount of bytes left, alignment can make less available
+   *
+   * @return size_t bytes left
+   */
+  size_t remaining() const noexcept {
+    return storageSize - offset;
+  }
+
+  /**
+   * @brief Most bytes in use at the same time, for sizing the storage
+   *
+   * @return size_t high water mark in bytes
+   */
+  size_t highWaterMark() const noexcept {
+    return highWater;
+  }
+
+  /**
+   * @brief Size of the storage
+   *
+   * @return size_t storage size in bytes
+   */
+  size_t capacity() const noexcept {
+    return storageSize;
+  }
+
+ private:
+  uint8_t *storageBegin; /**< start of the storage */
+  size_t storageSize;    /**< size of the storage */
+  size_t offset = 0;     /**< start of the free part of the storage */
+  size_t highWater = 0;  /**< most bytes in use at the same time */
+};
+
+/**
+ * @brief Rewinds an arena to the position it had when the scope was entered
+ *
+ * Example:
+ *
+ *   {
+ *     util::arenaScope scope(scratch);
+ *     char *line = scratch.allocateArray<char>(64);
+ *     ...
+ *   } // line is released here
+ */
+class arenaScope {
+ public:
+  /**
+   * @brief Marks the current position of the arena
+   *
+   * @param scopeArena arena to rewind when the scope ends
+   */
+  explicit arenaScope(arena &scopeArena) noexcept : scopeArena{scopeArena}, position{scopeArena.checkpoint()} {}
+
+  arenaScope(const arenaScope &) = delete;
+  arenaScope &operator=(const arenaScope &) = delete;
+
+  ~arenaScope() {
+    scopeArena.rewind(position);
+  }
+
+ private:
+  arena &scopeArena;                /**< arena to rewind */
+  arena::checkpointType position;   /**< position at the start of the scope */
+};
+
+}  // namespace util
+
+#endif
@@ -0,0 +1,55 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file arena_resource.hpp
+ *
+ * Polymorphic memory resource on top of an arena, only for hosts as it depends on the standard library
+ *
+ */
+#ifndef ARENA_RESOURCE_HPP
+#define ARENA_RESOURCE_HPP
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <arena.hpp>
+
+namespace util {
+
+/**
+ * @brief Makes an arena usable by the std::pmr containers
+ *
+ * Deallocation does nothing, memory returns to the arena when it is rewound or reset.
+ */
+class arenaResource : public std::pmr::memory_resource {
+ public:
+  /**
+   * @brief Creates a resource allocating from an arena, the arena must outlive the resource
+   *
+   * @param resourceArena arena to allocate from
+   */
+  explicit arenaResource(arena &resourceArena) noexcept : resourceArena{resourceArena} {}
+
+ private:
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    void *memory = resourceArena.allocate(bytes, alignment);
+    if (memory == nullptr) throw std::bad_alloc();
+    return memory;
+  }
+
+  void do_deallocate(void *, size_t, size_t) override {}
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+
+  arena &resourceArena; /**< arena to allocate from */
+};
+
+}  // namespace util
+
+#endif
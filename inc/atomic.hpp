@@ -50,8 +50,86 @@ constexpr memory_order get_default_memory_order() {
   return memory_order::seq_cst;
 }
 
+/** \brief Implementation strategy of atomic operations */
+enum class atomic_backend {
+  native,           /**< all operations map to the GCC atomic builtins */
+  critical_rmw,     /**< loads and stores are native, read modify write operations use a critical section */
+  critical_section  /**< all operations use a critical section */
+};
+
+#if defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M')
+/** \brief Short critical section that masks interrupts with PRIMASK and restores the previous mask on destruction
+
+Critical sections can be nested, the outermost one unmasks interrupts again.
+*/
+class critical_section {
+ public:
+  critical_section() noexcept {
+    __asm volatile("mrs %0, primask\n\tcpsid i" : "=r"(primask)::"memory");
+  }
+
+  critical_section(const critical_section&) = delete;
+  critical_section& operator=(const critical_section&) = delete;
+
+  ~critical_section() {
+    __asm volatile("msr primask, %0" ::"r"(primask) : "memory");
+  }
+
+ private:
+  unsigned int primask; /**< interrupt mask when the critical section was entered */
+};
+
+/** \brief Selects the backend for a type on Cortex-M
+
+ARMv6-M has no exclusive load and store instructions, so read modify write operations need a critical section there.
+GCC reports no size as lock free on ARMv6-M for that reason, so it is checked before the lock free test to keep word
+loads and stores native. Types larger then a word have no native load and store on any Cortex-M.
+\return backend to use for the type
+*/
+template <typename T>
+constexpr atomic_backend select_atomic_backend() {
+#if defined(__ARM_ARCH_6M__)
+  if constexpr (sizeof(T) <= sizeof(unsigned int))
+    return atomic_backend::critical_rmw;
+  else
+    return atomic_backend::critical_section;
+#else
+  if constexpr ((sizeof(T) > sizeof(unsigned int)) || !__atomic_always_lock_free(sizeof(T), 0))
+    return atomic_backend::critical_section;
+  else
+    return atomic_backend::native;
+#endif
+}
+#else
+/** \brief Placeholder on other targets, the critical section backends are never selected there */
+class critical_section {};
+
+/** \brief Selects the backend for a type on other targets, these rely on the GCC atomic builtins
+\return backend to use for the type
+*/
+template <typename T>
+constexpr atomic_backend select_atomic_backend() {
+  return atomic_backend::native;
+}
+#endif
+
 }  // namespace detail
 
+/** \brief Memory fence between threads, modeled after std::atomic_thread_fence
+\param mo memory order of the fence
+*/
+inline void atomic_thread_fence(memory_order mo) noexcept {
+  __atomic_thread_fence(detail::to_atomic_memorder(mo));
+}
+
+/** \brief Compiler only fence between a thread and an interrupt on the same core, modeled after
+std::atomic_signal_fence
+\param mo memory order of the fence
+*/
+inline void atomic_signal_fence(memory_order mo) noexcept {
+  __atomic_signal_fence(detail::to_atomic_memorder(mo));
+}
+
 /** \brief Standard atomic type modeled after std::atomic
 
 Standard atomic type modeled after the C++ std::atomic type.
@@ -61,6 +139,21 @@ Standard atomic type modeled after the C++ std::atomic type.
 template <typename T>
 class atomic {
  public:
+  /** \brief backend used for the operations on this type */
+  static constexpr detail::atomic_backend backend = detail::select_atomic_backend<T>();
+
+  /** \brief true when all operations on this type are lock free on this target, data structures can use this to select
+  a strategy at compile time */
+  static constexpr bool is_always_lock_free =
+      (backend == detail::atomic_backend::native) && __atomic_always_lock_free(sizeof(T), 0);
+
+  /** \brief Returns if the operations on this object are lock free
+  \return true if all operations are lock free
+  */
+  bool is_lock_free() const noexcept {
+    return (backend == detail::atomic_backend::native) && __atomic_is_lock_free(sizeof(T), &a_value);
+  }
+
   /** \brief default constructor **/
   atomic(T value = {}) noexcept {
     store(value);
@@ -77,7 +170,12 @@ class atomic {
   \param mo requested memory order
   **/
   void store(T value, memory_order mo = detail::get_default_memory_order()) noexcept {
-    __atomic_store(&a_value, &value, detail::to_atomic_memorder(mo));
+    if constexpr (backend == detail::atomic_backend::critical_section) {
+      detail::critical_section guard;
+      a_value = value;
+    } else {
+      __atomic_store(&a_value, &value, detail::to_atomic_memorder(mo));
+    }
   }
 
   /** \brief Assignment operator
@@ -95,7 +193,12 @@ class atomic {
   **/
   T load(memory_order mo = detail::get_default_memory_order()) const noexcept {
     T value;
-    __atomic_load(&a_value, &value, detail::to_atomic_memorder(mo));
+    if constexpr (backend == detail::atomic_backend::critical_section) {
+      detail::critical_section guard;
+      value = a_value;
+    } else {
+      __atomic_load(&a_value, &value, detail::to_atomic_memorder(mo));
+    }
     return value;
   }
 
@@ -113,7 +216,14 @@ class atomic {
   \return result of the addition
   **/
   T fetch_add(T arg, memory_order mo = detail::get_default_memory_order()) noexcept {
-    return __atomic_fetch_add(&a_value, arg, detail::to_atomic_memorder(mo));
+    if constexpr (backend != detail::atomic_backend::native) {
+      detail::critical_section guard;
+      T prev = a_value;
+      a_value = static_cast<T>(prev + arg);
+      return prev;
+    } else {
+      return __atomic_fetch_add(&a_value, arg, detail::to_atomic_memorder(mo));
+    }
   }
 
   /** \brief subtracts argument from the atomic object and returns the result
@@ -122,7 +232,14 @@ class atomic {
   \return result of the subtraction
   **/
   T fetch_sub(T arg, memory_order mo = detail::get_default_memory_order()) noexcept {
-    return __atomic_fetch_sub(&a_value, arg, detail::to_atomic_memorder(mo));
+    if constexpr (backend != detail::atomic_backend::native) {
+      detail::critical_section guard;
+      T prev = a_value;
+      a_value = static_cast<T>(prev - arg);
+      return prev;
+    } else {
+      return __atomic_fetch_sub(&a_value, arg, detail::to_atomic_memorder(mo));
+    }
   }
 
   /** \brief performs a bitwise AND with the atomic object and returns the result
@@ -131,7 +248,14 @@ class atomic {
   \return result of the bitwise AND
   **/
   T fetch_and(T arg, memory_order mo = detail::get_default_memory_order()) noexcept {
-    return __atomic_fetch_and(&a_value, arg, detail::to_atomic_memorder(mo));
+    if constexpr (backend != detail::atomic_backend::native) {
+      detail::critical_section guard;
+      T prev = a_value;
+      a_value = static_cast<T>(prev & arg);
+      return prev;
+    } else {
+      return __atomic_fetch_and(&a_value, arg, detail::to_atomic_memorder(mo));
+    }
   }
 
   /** \brief performs a bitwise OR with the atomic object and returns the result
@@ -140,7 +264,14 @@ class atomic {
   \return result of the bitwise OR
   **/
   T fetch_or(T arg, memory_order mo = detail::get_default_memory_order()) noexcept {
-    return __atomic_fetch_or(&a_value, arg, detail::to_atomic_memorder(mo));
+    if constexpr (backend != detail::atomic_backend::native) {
+      detail::critical_section guard;
+      T prev = a_value;
+      a_value = static_cast<T>(prev | arg);
+      return prev;
+    } else {
+      return __atomic_fetch_or(&a_value, arg, detail::to_atomic_memorder(mo));
+    }
   }
 
   /** \brief performs a bitwise XOR with the atomic object and returns the result
@@ -149,7 +280,14 @@ class atomic {
   \return result of the bitwise XOR
   **/
   T fetch_xor(T arg, memory_order mo = detail::get_default_memory_order()) noexcept {
-    return __atomic_fetch_xor(&a_value, arg, detail::to_atomic_memorder(mo));
+    if constexpr (backend != detail::atomic_backend::native) {
+      detail::critical_section guard;
+      T prev = a_value;
+      a_value = static_cast<T>(prev ^ arg);
+      return prev;
+    } else {
+      return __atomic_fetch_xor(&a_value, arg, detail::to_atomic_memorder(mo));
+    }
   }
 
   /** \brief replace the value of the atomic object and returns the previous object
@@ -159,8 +297,15 @@ class atomic {
   **/
   T exchange(T value, memory_order mo = detail::get_default_memory_order()) noexcept {
     T prev;
-    __atomic_exchange(&a_value, &value, &prev, detail::to_atomic_memorder(mo));
-    return prev;
+    if constexpr (backend != detail::atomic_backend::native) {
+      detail::critical_section guard;
+      prev = a_value;
+      a_value = value;
+      return prev;
+    } else {
+      __atomic_exchange(&a_value, &value, &prev, detail::to_atomic_memorder(mo));
+      return prev;
+    }
   }
 
   /** \brief try and compare and exchange the value
@@ -171,8 +316,12 @@ class atomic {
   \return true if the atomic value has been succesfully changed
   **/
   bool compare_exchange_weak(T& expected, T desired, memory_order success, memory_order failure) noexcept {
-    return __atomic_compare_exchange(&a_value, &expected, &desired, true, detail::to_atomic_memorder(success),
-                                     detail::to_atomic_memorder(failure));
+    if constexpr (backend != detail::atomic_backend::native) {
+      return locked_compare_exchange(expected, desired);
+    } else {
+      return __atomic_compare_exchange(&a_value, &expected, &desired, true, detail::to_atomic_memorder(success),
+                                       detail::to_atomic_memorder(failure));
+    }
   }
 
   /** \brief try and compare and exchange the value
@@ -196,8 +345,12 @@ class atomic {
   when you do not want a loop like in the weak version.
   **/
   bool compare_exchange_strong(T& expected, T desired, memory_order success, memory_order failure) noexcept {
-    return __atomic_compare_exchange(&a_value, &expected, &desired, false, detail::to_atomic_memorder(success),
-                                     detail::to_atomic_memorder(failure));
+    if constexpr (backend != detail::atomic_backend::native) {
+      return locked_compare_exchange(expected, desired);
+    } else {
+      return __atomic_compare_exchange(&a_value, &expected, &desired, false, detail::to_atomic_memorder(success),
+                                       detail::to_atomic_memorder(failure));
+    }
   }
 
   /** \brief try and compare and exchange the value
@@ -282,9 +435,29 @@ class atomic {
   }
 
  private:
+  /** \brief compare and exchange inside a critical section
+  \param expected expected value of the comparison, updated with the current value on failure
+  \param desired value to store if the expected value is found
+  \return true if the atomic value has been succesfully changed
+  **/
+  bool locked_compare_exchange(T& expected, T desired) noexcept {
+    detail::critical_section guard;
+    if (__builtin_memcmp(&a_value, &expected, sizeof(T)) == 0) {
+      a_value = desired;
+      return true;
+    }
+    expected = a_value;
+    return false;
+  }
+
   /** \brief atomic object */
   T a_value;
 };
+
+#if defined(__ARM_ARCH_6M__)
+static_assert(atomic<unsigned int>::backend == detail::atomic_backend::critical_rmw,
+              "word loads and stores must stay native on ARMv6-M");
+#endif
 }  // namespace util
 
 #endif
@@ -0,0 +1,137 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file binlog.hpp
+ *
+ * Deferred binary logging, format strings stay on the host and only identifiers and raw arguments are logged
+ *
+ * Every BINLOG call site puts its format string in the binlog section, the identifier of a message is the offset of its
+ * format string in that section. Place the section in a NOLOAD or INFO output section in the linker script so the strings
+ * take no target memory, for example:
+ *
+ *   binlog (INFO) : { KEEP(*(binlog)) }
+ *
+ * The host decoder needs the contents of that section as string table, it can be extracted from the ELF file with:
+ *
+ *   objcopy -O binary --only-section=binlog firmware.elf binlog.bin
+ *
+ * A logged message is stored as a record: 16 bit identifier, 8 bit argument count and 32 bits per argument, all little
+ * endian. Supported format specifiers are %u, %d, %x, %c and %%.
+ */
+#ifndef BINLOG_HPP
+#define BINLOG_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include <ringbuf.hpp>
+
+extern "C" const char __start_binlog[];  // provided by the linker
+
+/**
+ * @brief Logs a message with up to 255 integral arguments of at most 32 bits
+ *
+ * @param log     util::binaryLog instance to log into
+ * @param format  string literal with the format of the message
+ */
+#define BINLOG(log, format, ...)                                                                     \
+  do {                                                                                               \
+    __attribute__((section("binlog"), used)) static const char binlogFormat[] = format;              \
+    (log).write(static_cast<uint16_t>(binlogFormat - __start_binlog) __VA_OPT__(, ) __VA_ARGS__); \
+  } while (0)
+
+namespace util {
+
+/**
+ * @brief Binary log buffer, messages are stored as records in a ringbuffer of bytes
+ *
+ * Not safe for concurrent writers, protect write calls with a critical section when logging from multiple contexts.
+ *
+ * @tparam N size of the log buffer in bytes
+ */
+template <size_t N>
+class binaryLog {
+ public:
+  static constexpr size_t headerSize = 3; /**< identifier and argument count */
+
+  /**
+   * @brief Stores a record with the message identifier and its arguments, the record is dropped when it does not fit
+   *
+   * @tparam Args   integral, enum or pointer types of at most 32 bits
+   * @param id      message identifier
+   * @param args    message arguments
+   * @return true   record stored
+   * @return false  buffer full, record dropped
+   */
+  template <typename... Args>
+  bool write(uint16_t id, Args... args) {
+    static_assert(sizeof...(Args) <= 255, "too many arguments for a binary log record");
+    static_assert(((sizeof(Args) <= sizeof(uint32_t)) && ...), "binary log arguments can be at most 32 bits");
+    if (buffer.free() < (headerSize + sizeof...(Args) * sizeof(uint32_t))) {
+      dropped++;
+      return false;
+    }
+    pushWord(id, 2);
+    buffer.pushFront(static_cast<uint8_t>(sizeof...(Args)));
+    (pushWord(toWord(args), 4), ...);
+    return true;
+  }
+
+  /**
+   * @brief Takes the oldest byte out of the log, for transferring the log to the host
+   *
+   * @param byte    destination of the byte
+   * @return true   byte taken
+   * @return false  log empty
+   */
+  bool read(uint8_t &byte) {
+    return buffer.popBack(byte);
+  }
+
+  /**
+   * @brief Amount of bytes in the log
+   *
+   * @return size_t amount of bytes
+   */
+  size_t size() const {
+    return buffer.size();
+  }
+
+  /**
+   * @brief Amount of records dropped because the log was full
+   *
+   * @return uint32_t amount of dropped records
+   */
+  uint32_t droppedRecords() const {
+    return dropped;
+  }
+
+ private:
+  template <typename T>
+  static uint32_t toWord(T value) {
+    if constexpr (std::is_pointer_v<T>)
+      return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(value));
+    else if constexpr (std::is_enum_v<T>)
+      return static_cast<uint32_t>(static_cast<std::underlying_type_t<T>>(value));
+    else
+      return static_cast<uint32_t>(value);
+  }
+
+  void pushWord(uint32_t word, unsigned int bytes) {
+    for (unsigned int i = 0; i < bytes; i++) {
+      buffer.pushFront(static_cast<uint8_t>(word));
+      word = word >> 8;
+    }
+  }
+
+  RingBuffer<uint8_t, N> buffer; /**< log records */
+  uint32_t dropped = 0;          /**< records dropped because the log was full */
+};
+
+}  // namespace util
+
+#endif
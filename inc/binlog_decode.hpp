@@ -0,0 +1,85 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file binlog_decode.hpp
+ *
+ * Decoding of binary log records back into text, meant for the host side tooling that reads the log of a target
+ *
+ */
+#ifndef BINLOG_DECODE_HPP
+#define BINLOG_DECODE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <format.hpp>
+
+namespace util {
+
+/**
+ * @brief Decodes the first binary log record of a byte sequence into text
+ *
+ * The format string of the record is looked up in the string table, this is the contents of the binlog section of the
+ * firmware. Arguments of %u are printed as unsigned decimal, %d as signed decimal, %x as 8 digit hex and %c as character.
+ *
+ * @param records   bytes read from the binary log, starting at a record
+ * @param strings   string table, contents of the binlog section
+ * @param buffer    span to append the text to, updated to the remaining space
+ * @return size_t   amount of bytes of the record, 0 when records does not hold a complete valid record
+ */
+inline size_t binlogDecode(std::span<const uint8_t> records, std::span<const char> strings, std::span<char> &buffer) {
+  if (records.size() < 3) return 0;
+  const size_t id = static_cast<size_t>(records[0]) | (static_cast<size_t>(records[1]) << 8);
+  const size_t argCount = records[2];
+  const size_t recordSize = 3 + argCount * 4;
+  if ((records.size() < recordSize) || (id >= strings.size())) return 0;
+  auto argument = [&records](size_t index) -> uint32_t {
+    const size_t offset = 3 + index * 4;
+    return static_cast<uint32_t>(records[offset]) | (static_cast<uint32_t>(records[offset + 1]) << 8) |
+           (static_cast<uint32_t>(records[offset + 2]) << 16) | (static_cast<uint32_t>(records[offset + 3]) << 24);
+  };
+  size_t nextArgument = 0;
+  for (size_t i = id; (i < strings.size()) && (strings[i] != '\0'); i++) {
+    if ((strings[i] != '%') || (i + 1 >= strings.size()) || (strings[i + 1] == '\0')) {
+      buffer = appendChar(buffer, strings[i]);
+      continue;
+    }
+    const char specifier = strings[++i];
+    if (specifier == '%') {
+      buffer = appendChar(buffer, '%');
+      continue;
+    }
+    if (nextArgument >= argCount) {
+      buffer = appendChar(buffer, '?');
+      continue;
+    }
+    const uint32_t value = argument(nextArgument++);
+    switch (specifier) {
+      case 'u':
+        buffer = appendDec(buffer, value);
+        break;
+      case 'd':
+        buffer = appendDec(buffer, static_cast<int32_t>(value));
+        break;
+      case 'x':
+        buffer = appendHex(buffer, value);
+        break;
+      case 'c':
+        buffer = appendChar(buffer, static_cast<char>(value));
+        break;
+      default:
+        buffer = appendChar(buffer, '%');
+        buffer = appendChar(buffer, specifier);
+        break;
+    }
+  }
+  return recordSize;
+}
+
+}  // namespace util
+
+#endif
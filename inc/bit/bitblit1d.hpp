@@ -13,73 +13,32 @@
 #ifndef BITBLIT1D_HPP
 #define BITBLIT1D_HPP
 
-#include <limits>
+#include <cstdint>
 #include <bit/operations.hpp>
-#include <bit/readmodifywrite.hpp>
+#include <bit/bitstream.hpp>
 
 namespace util {
+
+/**
+ * @brief One dimensional bit block transfer, clipped to the destination
+ *
+ * @tparam destType   destination element type
+ * @tparam srcType    source element type
+ * @param dest        destination row
+ * @param destWidth   destination width in bits
+ * @param destX       destination X position to write source
+ * @param src         source row
+ * @param srcWidth    source width in bits
+ * @param op          operation to execute
+ */
 template <typename destType, typename srcType>
 void bitblit1d(destType *__restrict__ dest, unsigned int destWidth, unsigned int destX, const srcType *__restrict__ src,
                unsigned int srcWidth, bitblitOperation op) noexcept {
   if (destX >= destWidth) return;  // out of bounds, abort
-  // compute count and clamp if needed
-  const unsigned int elementBitCnt = std::numeric_limits<destType>::digits;
-  unsigned int count;
-  bool abortLastWrite;
-  if ((srcWidth + destX) >= destWidth) {
-    // this double divide makes sure we have a correct count
-    count = (destWidth / elementBitCnt) - (destX / elementBitCnt);
-    abortLastWrite = true;
-  } else {
-    count = srcWidth / elementBitCnt;
-    abortLastWrite = false;
-  }
-  // extract special case for aligned writes and adjust counts
-  bool alignedWrites = (destX & 7) == 0;
-  if (count > 0 && !alignedWrites) count--;
-  dest = dest + destX / elementBitCnt;
-  // compute masks and bit positions
-  int destBit = destX & 7;
-  unsigned int endBit = destBit + srcWidth;
-  unsigned int remainderBits = endBit & 7;
-  destType mask = 0xFF << destBit;
-
-  if (srcWidth < elementBitCnt && endBit < 9) {  // case for less then element bits write within a single element
-    mask = mask & ~(0xFF << (destBit + srcWidth));
-    readModifyWrite(dest, src, mask, destBit, op);
-    return;
-  }
-
-  if (alignedWrites) {  // case for aligned writes
-    unsigned int i = count;
-    while (i > 0) {
-      readModifyWrite(dest, src, mask, 0, op);
-      dest++;
-      src++;
-      i--;
-    }
-    if (remainderBits && !abortLastWrite) {  // handle remainder of bits
-      mask = 0xFF >> (remainderBits);
-      readModifyWrite(dest, src, mask, 0, op);
-    }
-
-  } else {  // case for unaligned writes single and multiple
-    // first element start
-    readModifyWrite(dest, src, mask, destBit, op);
-    dest++;
-    while (count > 0) {  // do the rest
-      readModifyWrite(dest, src, static_cast<uint8_t>(~mask), -(elementBitCnt - destBit), op);
-      src++;
-      readModifyWrite(dest, src, mask, destBit, op);
-      dest++;
-      count--;
-    }
-    if (!abortLastWrite && remainderBits) {  // handle last
-      mask = 0xFF >> (remainderBits);
-      readModifyWrite(dest, src, mask, -(elementBitCnt - destBit), op);
-    }
-  }
+  // a row is a block of a single line, partial elements and unaligned positions are handled by the row transfer
+  detail::bitblit2dClipped<false>(dest, 0u, destWidth, 1u, static_cast<int>(destX), 0, src, srcWidth, srcWidth, 1u,
+                                  static_cast<const srcType *>(nullptr), op);
 }
 }  // namespace util
 
-#endif
\ No newline at end of file
+#endif
@@ -16,28 +16,96 @@
 #include <limits>
 #include <bit/operations.hpp>
 #include <bit/readmodifywrite.hpp>
+#include <bit/bitstream.hpp>
 
 namespace util {
 
 /**
- * @brief
- *
- * @tparam destType
- * @tparam srcType
- * @param dest
- * @param destWidth
- * @param destHeight
- * @param destX
- * @param destY
- * @param src
- * @param srcWidth
- * @param srcHeight
- * @param op
+ * @brief Two dimensional bit block transfer, fast version, with explicit strides and a source origin
+ *
+ * Transfers a whole destination element at a time, only the edges of the destination are masked. Row r of the source
+ * bitmap starts at bit r * srcStride, the block to transfer starts at srcX, srcY in the source bitmap so blocks can be
+ * taken out of sprite sheets. The destination stride allows framebuffers with out of band data between rows.
+ *
+ * @tparam destType   destination element type
+ * @tparam srcType    source element type
+ * @param dest        destination buffer
+ * @param destStride  elements between the start of two destination rows
+ * @param destWidth   destination buffer width
+ * @param destHeight  destination buffer height
+ * @param destX       destination X position to write source, can be negative
+ * @param destY       destination Y position to write source, can be negative
+ * @param src         source buffer
+ * @param srcStride   bits between the start of two source rows
+ * @param srcX        X position in the source of the block to transfer
+ * @param srcY        Y position in the source of the block to transfer
+ * @param srcWidth    width of the block to transfer
+ * @param srcHeight   height of the block to transfer
+ * @param op          operation to execute
+ */
+template <typename destType, typename srcType>
+void bitblit2dfast(destType *__restrict__ dest, unsigned int destStride, unsigned int destWidth, unsigned int destHeight,
+                   int destX, int destY, const srcType *__restrict__ src, unsigned int srcStride, unsigned int srcX,
+                   unsigned int srcY, unsigned int srcWidth, unsigned int srcHeight, bitblitOperation op) noexcept {
+  detail::bitblit2dClipped<false>(dest, destStride, destWidth, destHeight, destX, destY, src, srcStride, srcY * srcStride + srcX,
+                                  srcWidth, srcHeight, static_cast<const srcType *>(nullptr), op);
+}
+
+/**
+ * @brief Two dimensional bit block transfer, fast version, with an explicit source stride
+ *
+ * Transfers a whole destination element at a time, only the edges of the destination are masked. The source is read as
+ * a continuous bitstream, row r starts at bit r * srcStride. With srcStride equal to srcWidth the source rows are fully
+ * packed without padding.
+ *
+ * @tparam destType   destination element type
+ * @tparam srcType    source element type
+ * @param dest        destination buffer
+ * @param destWidth   destination buffer width
+ * @param destHeight  destination buffer height
+ * @param destX       destination X position to write source, can be negative
+ * @param destY       destination Y position to write source, can be negative
+ * @param src         source buffer
+ * @param srcStride   bits between the start of two source rows
+ * @param srcWidth    source width
+ * @param srcHeight   source height
+ * @param op          operation to execute
+ */
+template <typename destType, typename srcType>
+void bitblit2dfast(destType *__restrict__ dest, unsigned int destWidth, unsigned int destHeight, int destX, int destY,
+                   const srcType *__restrict__ src, unsigned int srcStride, unsigned int srcWidth, unsigned int srcHeight,
+                   bitblitOperation op) noexcept {
+  constexpr unsigned int destDigits = std::numeric_limits<destType>::digits;
+  bitblit2dfast(dest, destWidth / destDigits, destWidth, destHeight, destX, destY, src, srcStride, 0u, 0u, srcWidth, srcHeight,
+                op);
+}
+
+/**
+ * @brief Two dimensional bit block transfer, fast version
+ *
+ * Transfers a whole destination element at a time, only the edges of the destination are masked. The source is clipped
+ * on all four edges of the destination, so source bitmaps may start off-screen. Every source row starts on a new
+ * source element.
+ *
+ * @tparam destType   destination element type
+ * @tparam srcType    source element type
+ * @param dest        destination buffer
+ * @param destWidth   destination buffer width
+ * @param destHeight  destination buffer height
+ * @param destX       destination X position to write source, can be negative
+ * @param destY       destination Y position to write source, can be negative
+ * @param src         source buffer
+ * @param srcWidth    source width
+ * @param srcHeight   source height
+ * @param op          operation to execute
  */
 template <typename destType, typename srcType>
-void bitblit2dfast(destType *__restrict__ dest, unsigned int destWidth, unsigned int destHeight, unsigned int destX,
-                   unsigned int destY, const srcType *__restrict__ src, unsigned int srcWidth, unsigned int srcHeight,
-                   bitblitOperation op) noexcept {}
+void bitblit2dfast(destType *__restrict__ dest, unsigned int destWidth, unsigned int destHeight, int destX, int destY,
+                   const srcType *__restrict__ src, unsigned int srcWidth, unsigned int srcHeight, bitblitOperation op) noexcept {
+  constexpr unsigned int srcDigits = std::numeric_limits<srcType>::digits;
+  const unsigned int srcStride = ((srcWidth + srcDigits - 1) / srcDigits) * srcDigits;
+  bitblit2dfast(dest, destWidth, destHeight, destX, destY, src, srcStride, srcWidth, srcHeight, op);
+}
 
 };  // namespace util
 
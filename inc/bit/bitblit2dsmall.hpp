@@ -20,23 +20,32 @@
 namespace util {
 
 /**
- * @brief
+ * @brief Two dimensional bit block transfer, small version, with explicit strides and a source origin
  *
- * @tparam destType
- * @tparam srcType
- * @param dest
- * @param destWidth
- * @param destHeight
- * @param destX
- * @param destY
- * @param src
- * @param srcWidth
- * @param srcHeight
- * @param op
+ * Transfers a bit at a time. The source is read as a continuous bitstream, row r of the source bitmap starts at bit
+ * r * srcStride. The block to transfer starts at srcX, srcY in the source bitmap, so blocks can be taken out of sprite
+ * sheets. The destination stride allows framebuffers with out of band data between rows.
+ *
+ * @tparam destType   destination element type
+ * @tparam srcType    source element type
+ * @param dest        destination buffer
+ * @param destStride  elements between the start of two destination rows
+ * @param destWidth   destination buffer width
+ * @param destHeight  destination buffer height
+ * @param destX       destination X position to write source
+ * @param destY       destination Y position to write source
+ * @param src         source buffer
+ * @param srcStride   bits between the start of two source rows
+ * @param srcX        X position in the source of the block to transfer
+ * @param srcY        Y position in the source of the block to transfer
+ * @param srcWidth    width of the block to transfer
+ * @param srcHeight   height of the block to transfer
+ * @param op          operation to execute
  */
 template <typename destType, typename srcType>
-void bitblit2dsmall(destType *__restrict__ dest, unsigned int destWidth, unsigned int destHeight, unsigned int destX,
-                    unsigned int destY, const srcType *__restrict__ src, unsigned int srcWidth, unsigned int srcHeight,
+void bitblit2dsmall(destType *__restrict__ dest, unsigned int destStride, unsigned int destWidth, unsigned int destHeight,
+                    unsigned int destX, unsigned int destY, const srcType *__restrict__ src, unsigned int srcStride,
+                    unsigned int srcX, unsigned int srcY, unsigned int srcWidth, unsigned int srcHeight,
                     bitblitOperation op) noexcept {
   constexpr int destDigits = std::numeric_limits<destType>::digits;
   constexpr int srcDigits = std::numeric_limits<srcType>::digits;
@@ -55,7 +64,7 @@ void bitblit2dsmall(destType *__restrict__ dest, unsigned int destWidth, unsigne
     heightCount = srcHeight;
 
   // add height offset to destination
-  dest = dest + (destY * (destWidth / destDigits));
+  dest = dest + (destY * destStride);
 
   destType destMask;
   srcType srcMask;
@@ -63,16 +72,15 @@ void bitblit2dsmall(destType *__restrict__ dest, unsigned int destWidth, unsigne
   const srcType *currSrcLine;
 
   unsigned int widthCounter, heightCounter;
+  unsigned int srcBit = srcY * srcStride + srcX;
   heightCounter = heightCount;
   while (heightCounter > 0) {
-    // TODO, we have two types of source bitmaps, one where a new line does not use the remaining bits
-    // and a bitmap where we use ALL the bits on the end of the line, this is more compact for fonts and such
     widthCounter = widthCount;
     // do X iteration
     destMask = 1 << (destX & (destDigits - 1));
-    srcMask = 1;
+    srcMask = static_cast<srcType>(1) << (srcBit % srcDigits);
     currDestLine = dest + (destX / destDigits);
-    currSrcLine = src;
+    currSrcLine = src + (srcBit / srcDigits);
     while (widthCounter > 0) {
       bool srcPixel = (*currSrcLine & srcMask) ? true : false;
       bool destPixel = (*currDestLine & destMask) ? true : false;
@@ -114,11 +122,65 @@ void bitblit2dsmall(destType *__restrict__ dest, unsigned int destWidth, unsigne
       }
     }
     heightCounter--;
-    dest = dest + (destWidth / destDigits);
-    src = src + (srcWidth / srcDigits);
+    dest = dest + destStride;
+    srcBit = srcBit + srcStride;
   }
 }
 
+/**
+ * @brief Two dimensional bit block transfer, small version, with an explicit source stride
+ *
+ * Transfers a bit at a time. The source is read as a continuous bitstream, row r starts at bit r * srcStride. With
+ * srcStride equal to srcWidth the source rows are fully packed without padding.
+ *
+ * @tparam destType   destination element type
+ * @tparam srcType    source element type
+ * @param dest        destination buffer
+ * @param destWidth   destination buffer width
+ * @param destHeight  destination buffer height
+ * @param destX       destination X position to write source
+ * @param destY       destination Y position to write source
+ * @param src         source buffer
+ * @param srcStride   bits between the start of two source rows
+ * @param srcWidth    source width
+ * @param srcHeight   source height
+ * @param op          operation to execute
+ */
+template <typename destType, typename srcType>
+void bitblit2dsmall(destType *__restrict__ dest, unsigned int destWidth, unsigned int destHeight, unsigned int destX,
+                    unsigned int destY, const srcType *__restrict__ src, unsigned int srcStride, unsigned int srcWidth,
+                    unsigned int srcHeight, bitblitOperation op) noexcept {
+  constexpr unsigned int destDigits = std::numeric_limits<destType>::digits;
+  bitblit2dsmall(dest, destWidth / destDigits, destWidth, destHeight, destX, destY, src, srcStride, 0u, 0u, srcWidth, srcHeight,
+                 op);
+}
+
+/**
+ * @brief Two dimensional bit block transfer, small version
+ *
+ * Transfers a bit at a time. Every source row starts on a new source element.
+ *
+ * @tparam destType   destination element type
+ * @tparam srcType    source element type
+ * @param dest        destination buffer
+ * @param destWidth   destination buffer width
+ * @param destHeight  destination buffer height
+ * @param destX       destination X position to write source
+ * @param destY       destination Y position to write source
+ * @param src         source buffer
+ * @param srcWidth    source width
+ * @param srcHeight   source height
+ * @param op          operation to execute
+ */
+template <typename destType, typename srcType>
+void bitblit2dsmall(destType *__restrict__ dest, unsigned int destWidth, unsigned int destHeight, unsigned int destX,
+                    unsigned int destY, const srcType *__restrict__ src, unsigned int srcWidth, unsigned int srcHeight,
+                    bitblitOperation op) noexcept {
+  constexpr unsigned int srcDigits = std::numeric_limits<srcType>::digits;
+  const unsigned int srcStride = ((srcWidth + srcDigits - 1) / srcDigits) * srcDigits;
+  bitblit2dsmall(dest, destWidth, destHeight, destX, destY, src, srcStride, srcWidth, srcHeight, op);
+}
+
 };  // namespace util
 
 #endif
\ No newline at end of file
@@ -0,0 +1,246 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file bitblitdifferential.hpp
+ *
+ * Differential fuzzing and benchmarking of bitblit variants against the reference bitblit, only for hosts
+ *
+ */
+#ifndef BITBLITDIFFERENTIAL_HPP
+#define BITBLITDIFFERENTIAL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <vector>
+#include <bit/operations.hpp>
+#include <bit/bitblitreference.hpp>
+
+namespace util {
+namespace reference {
+
+/**
+ * @brief Parameters of a single randomized block transfer, same meaning as the explicit stride blitter parameters
+ *
+ */
+struct blitCase {
+  unsigned int destStride;        /*!< elements between the start of two destination rows */
+  unsigned int destWidth;         /*!< destination width, multiple of the destination element size for rows */
+  unsigned int destHeight;        /*!< destination height */
+  int destX;                      /*!< destination X position */
+  int destY;                      /*!< destination Y position */
+  unsigned int srcStride;         /*!< bits between the start of two source rows */
+  unsigned int srcX;              /*!< X position in the source of the block to transfer */
+  unsigned int srcY;              /*!< Y position in the source of the block to transfer */
+  unsigned int srcWidth;          /*!< width of the block to transfer */
+  unsigned int srcHeight;         /*!< height of the block to transfer */
+  bitblitOperation op;            /*!< operation to execute */
+  bitblitOrientation orientation; /*!< orientation to apply, ORIENT_NORMAL unless the limits allow orientations */
+  unsigned int patternLength;     /*!< amount of source elements used as fill pattern, 0 unless the limits allow patterns */
+};
+
+/**
+ * @brief Limits the randomized cases to what a blitter variant supports
+ *
+ */
+struct blitCaseLimits {
+  unsigned int maxDestWidth = 256;  /*!< maximum destination width */
+  unsigned int maxDestHeight = 48;  /*!< maximum destination height */
+  unsigned int maxSrcWidth = 96;    /*!< maximum width of the transferred block */
+  unsigned int maxSrcHeight = 32;   /*!< maximum height of the transferred block */
+  bool negativePositions = true;    /*!< destination positions can be negative or beyond the destination */
+  bool clipping = true;             /*!< blocks can extend beyond the right and bottom edge of the destination */
+  bool wholeElementWidths = false;  /*!< block widths are a multiple of the source element size */
+  bool alignedDestX = false;        /*!< destination X positions are a multiple of the source element size */
+  bool packedSource = true;         /*!< source rows do not have to start on a new source element */
+  bool sourceOrigin = true;         /*!< blocks are taken from a random position in a larger source */
+  bool destinationPadding = true;   /*!< destination rows can have extra elements beyond the width */
+  bool masked = false;              /*!< a random mask is passed and used by the reference */
+  bool orientations = false;        /*!< cases use a random orientation */
+  bool pagedDestination = false;    /*!< destination is page oriented, destStride is the amount of bytes between pages */
+  bool pattern = false;             /*!< cases use a random pattern length from 0 up to 4 */
+};
+
+/**
+ * @brief Outcome of a differential run
+ *
+ */
+struct differentialResult {
+  size_t cases = 0;                       /*!< amount of cases run */
+  size_t mismatches = 0;                  /*!< amount of cases where the variant differs from the reference */
+  blitCase firstMismatch = {};            /*!< parameters of the first mismatching case */
+  uint64_t pixels = 0;                    /*!< amount of visible pixels transferred by the variant */
+  std::chrono::nanoseconds time{0};       /*!< time spent in the variant, the reference is not included */
+
+  /**
+   * @brief Throughput of the variant
+   *
+   * @return double millions of pixels per second
+   */
+  double megaPixelsPerSecond() const {
+    if (time.count() == 0) return 0.0;
+    return static_cast<double>(pixels) * 1000.0 / static_cast<double>(time.count());
+  }
+};
+
+/**
+ * @brief Runs a blitter variant and the reference over randomized cases and compares the results
+ *
+ * Every case starts from the same random destination for variant and reference, the complete destination including
+ * padding is compared afterwards. The reference is called with the same parameters as the variant, the mask is nullptr
+ * when the limits are not masked. Example for the oriented blitter:
+ *
+ *   auto result = differentialRun<uint8_t, uint8_t>(
+ *       [](uint8_t *dest, const uint8_t *src, const uint8_t *, const blitCase &c) {
+ *         bitblit2doriented(dest, c.destStride, c.destWidth, c.destHeight, c.destX, c.destY, src, c.srcStride, c.srcX,
+ *                           c.srcY, c.srcWidth, c.srcHeight, c.orientation, c.op);
+ *       },
+ *       [](uint8_t *dest, const uint8_t *src, const uint8_t *, const blitCase &c) {
+ *         reference::bitblit2doriented<false>(dest, c.destStride, c.destWidth, c.destHeight, c.destX, c.destY, src,
+ *                                             c.srcStride, c.srcX, c.srcY, c.srcWidth, c.srcHeight, c.orientation, c.op);
+ *       },
+ *       limits, 10000, 1);
+ *
+ * @tparam destType           destination element type
+ * @tparam srcType            source element type
+ * @tparam blitFunction       callable taking (destType *dest, const srcType *src, const srcType *mask, const blitCase &c)
+ * that runs the variant under test
+ * @tparam referenceFunction  callable with the same signature as blitFunction that runs the reference
+ * @param blit                variant under test
+ * @param reference           reference, must be written independently of the variant
+ * @param limits              limits for the randomized cases
+ * @param caseCount           amount of cases to run
+ * @param seed                random seed, runs with the same seed use the same cases
+ * @return differentialResult mismatches and throughput
+ */
+template <typename destType, typename srcType, typename blitFunction, typename referenceFunction>
+differentialResult differentialRun(blitFunction &&blit, referenceFunction &&reference, const blitCaseLimits &limits,
+                                   size_t caseCount, uint32_t seed) {
+  constexpr unsigned int destDigits = std::numeric_limits<destType>::digits;
+  constexpr unsigned int srcDigits = std::numeric_limits<srcType>::digits;
+  std::mt19937 generator(seed);
+  auto random = [&generator](unsigned int low, unsigned int high) {
+    return std::uniform_int_distribution<unsigned int>(low, high)(generator);
+  };
+  differentialResult result;
+  std::vector<destType> dest, expected;
+  std::vector<srcType> src, mask;
+  for (size_t i = 0; i < caseCount; i++) {
+    blitCase c;
+    if (limits.pagedDestination) {
+      c.destWidth = random(1, limits.maxDestWidth);
+      c.destHeight = 8 * random(1, std::max(limits.maxDestHeight / 8, 1u));
+      c.destStride = c.destWidth + (limits.destinationPadding ? random(0, 2) : 0);
+    } else {
+      c.destWidth = destDigits * random(1, (limits.maxDestWidth + destDigits - 1) / destDigits);
+      c.destHeight = random(1, limits.maxDestHeight);
+      c.destStride = c.destWidth / destDigits + (limits.destinationPadding ? random(0, 2) : 0);
+    }
+    c.orientation = limits.orientations ? static_cast<bitblitOrientation>(random(0, 7)) : bitblitOrientation::ORIENT_NORMAL;
+    const bool swapped = (c.orientation == bitblitOrientation::ORIENT_ROTATE90) ||
+                         (c.orientation == bitblitOrientation::ORIENT_ROTATE270) ||
+                         (c.orientation == bitblitOrientation::ORIENT_TRANSPOSE) ||
+                         (c.orientation == bitblitOrientation::ORIENT_ANTITRANSPOSE);
+    const unsigned int destColumns = swapped ? c.destHeight : c.destWidth;
+    const unsigned int destRows = swapped ? c.destWidth : c.destHeight;
+    const unsigned int maxWidth = limits.clipping ? limits.maxSrcWidth : std::min(limits.maxSrcWidth, destColumns);
+    const unsigned int maxHeight = limits.clipping ? limits.maxSrcHeight : std::min(limits.maxSrcHeight, destRows);
+    c.srcWidth = random(1, maxWidth);
+    if (limits.wholeElementWidths) c.srcWidth = srcDigits * random(1, std::max(maxWidth / srcDigits, 1u));
+    c.srcHeight = random(1, maxHeight);
+    c.srcX = limits.sourceOrigin ? random(0, 2 * srcDigits) : 0;
+    c.srcY = limits.sourceOrigin ? random(0, 4) : 0;
+    c.srcStride = c.srcX + c.srcWidth + (limits.sourceOrigin ? random(0, srcDigits) : 0);
+    if (!limits.packedSource) c.srcStride = ((c.srcStride + srcDigits - 1) / srcDigits) * srcDigits;
+    // extent of the block in the destination
+    const unsigned int blockWidth = swapped ? c.srcHeight : c.srcWidth;
+    const unsigned int blockHeight = swapped ? c.srcWidth : c.srcHeight;
+    if (limits.negativePositions) {
+      c.destX = static_cast<int>(random(0, c.destWidth + blockWidth)) - static_cast<int>(blockWidth);
+      c.destY = static_cast<int>(random(0, c.destHeight + blockHeight)) - static_cast<int>(blockHeight);
+    } else if (limits.clipping) {
+      c.destX = static_cast<int>(random(0, c.destWidth - 1));
+      c.destY = static_cast<int>(random(0, c.destHeight - 1));
+    } else {
+      c.destX = static_cast<int>(random(0, c.destWidth - std::min(blockWidth, c.destWidth)));
+      c.destY = static_cast<int>(random(0, c.destHeight - blockHeight));
+    }
+    if (limits.alignedDestX) c.destX = (c.destX / static_cast<int>(srcDigits)) * static_cast<int>(srcDigits);
+    c.op = static_cast<bitblitOperation>(random(0, 4));
+    c.patternLength = limits.pattern ? random(0, 4) : 0;
+
+    dest.resize(limits.pagedDestination ? c.destStride * (c.destHeight / 8) : c.destStride * c.destHeight);
+    src.resize(std::max<size_t>((c.srcStride * (c.srcY + c.srcHeight) + srcDigits - 1) / srcDigits + 1, c.patternLength));
+    mask.resize(src.size());
+    for (destType &element : dest) element = static_cast<destType>(generator());
+    for (srcType &element : src) element = static_cast<srcType>(generator());
+    for (srcType &element : mask) element = static_cast<srcType>(generator());
+    expected = dest;
+    reference(expected.data(), static_cast<const srcType *>(src.data()),
+              limits.masked ? static_cast<const srcType *>(mask.data()) : static_cast<const srcType *>(nullptr), c);
+
+    const auto start = std::chrono::steady_clock::now();
+    blit(dest.data(), static_cast<const srcType *>(src.data()), static_cast<const srcType *>(mask.data()), c);
+    result.time += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    const int visibleWidth =
+        std::min(c.destX + static_cast<int>(blockWidth), static_cast<int>(c.destWidth)) - std::max(c.destX, 0);
+    const int visibleHeight =
+        std::min(c.destY + static_cast<int>(blockHeight), static_cast<int>(c.destHeight)) - std::max(c.destY, 0);
+    if ((visibleWidth > 0) && (visibleHeight > 0)) result.pixels += static_cast<uint64_t>(visibleWidth * visibleHeight);
+
+    unsigned int mismatchX, mismatchY;
+    const unsigned int rows = limits.pagedDestination ? c.destHeight / 8 : c.destHeight;
+    if (!compare(dest.data(), expected.data(), c.destStride, rows, mismatchX, mismatchY)) {
+      if (result.mismatches == 0) result.firstMismatch = c;
+      result.mismatches++;
+    }
+    result.cases++;
+  }
+  return result;
+}
+
+/**
+ * @brief Runs a blitter variant against the reference bitblit over randomized cases, see differentialRun above
+ *
+ * Example for the fast blitter:
+ *
+ *   auto result = differentialRun<uint16_t, uint8_t>(
+ *       [](uint16_t *dest, const uint8_t *src, const uint8_t *, const blitCase &c) {
+ *         bitblit2dfast(dest, c.destStride, c.destWidth, c.destHeight, c.destX, c.destY, src, c.srcStride, c.srcX, c.srcY,
+ *                       c.srcWidth, c.srcHeight, c.op);
+ *       },
+ *       blitCaseLimits{}, 10000, 1);
+ *
+ * @tparam destType     destination element type
+ * @tparam srcType      source element type
+ * @tparam blitFunction callable taking (destType *dest, const srcType *src, const srcType *mask, const blitCase &c) that
+ * runs the variant under test
+ * @param blit          variant under test
+ * @param limits        limits for the randomized cases
+ * @param caseCount     amount of cases to run
+ * @param seed          random seed, runs with the same seed use the same cases
+ * @return differentialResult mismatches and throughput
+ */
+template <typename destType, typename srcType, typename blitFunction>
+differentialResult differentialRun(blitFunction &&blit, const blitCaseLimits &limits, size_t caseCount, uint32_t seed) {
+  return differentialRun<destType, srcType>(
+      blit,
+      [](destType *dest, const srcType *src, const srcType *mask, const blitCase &c) {
+        bitblit2d(dest, c.destStride, c.destWidth, c.destHeight, c.destX, c.destY, src, c.srcStride, c.srcX, c.srcY, c.srcWidth,
+                  c.srcHeight, mask, c.op);
+      },
+      limits, caseCount, seed);
+}
+
+}  // namespace reference
+}  // namespace util
+
+#endif
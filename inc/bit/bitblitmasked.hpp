@@ -0,0 +1,86 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2022 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file bitblitmasked.hpp
+ *
+ * 2d bitblit routine with a separate mask plane, used for sprites
+ *
+ */
+#ifndef BITBLITMASKED_HPP
+#define BITBLITMASKED_HPP
+
+#include <limits>
+#include <bit/operations.hpp>
+#include <bit/bitstream.hpp>
+
+namespace util {
+
+/**
+ * @brief Two dimensional masked bit block transfer, with explicit strides and a source origin
+ *
+ * The mask has the same layout as the source, the block to transfer starts at srcX, srcY in both.
+ *
+ * @tparam destType   destination element type
+ * @tparam srcType    source and mask element type
+ * @param dest        destination buffer
+ * @param destStride  elements between the start of two destination rows
+ * @param destWidth   destination buffer width
+ * @param destHeight  destination buffer height
+ * @param destX       destination X position to write source, can be negative
+ * @param destY       destination Y position to write source, can be negative
+ * @param src         source buffer
+ * @param mask        mask buffer, a set bit makes the source bit visible
+ * @param srcStride   bits between the start of two source and mask rows
+ * @param srcX        X position in the source of the block to transfer
+ * @param srcY        Y position in the source of the block to transfer
+ * @param srcWidth    width of the block to transfer
+ * @param srcHeight   height of the block to transfer
+ * @param op          operation to execute on the visible bits
+ */
+template <typename destType, typename srcType>
+void bitblit2dmasked(destType *__restrict__ dest, unsigned int destStride, unsigned int destWidth, unsigned int destHeight,
+                     int destX, int destY, const srcType *__restrict__ src, const srcType *__restrict__ mask,
+                     unsigned int srcStride, unsigned int srcX, unsigned int srcY, unsigned int srcWidth, unsigned int srcHeight,
+                     bitblitOperation op) noexcept {
+  detail::bitblit2dClipped<true>(dest, destStride, destWidth, destHeight, destX, destY, src, srcStride, srcY * srcStride + srcX,
+                                 srcWidth, srcHeight, mask, op);
+}
+
+/**
+ * @brief Two dimensional masked bit block transfer
+ *
+ * Only destination bits that have their corresponding mask bit set are touched, with OP_MOV this results in
+ * dest = (dest & ~mask) | (src & mask). The mask has the same dimensions and layout as the source. The source is clipped
+ * on all four edges of the destination, so sprites may start off-screen. Transfers a whole destination element at a time.
+ *
+ * @tparam destType   destination element type
+ * @tparam srcType    source and mask element type
+ * @param dest        destination buffer
+ * @param destWidth   destination buffer width
+ * @param destHeight  destination buffer height
+ * @param destX       destination X position to write source, can be negative
+ * @param destY       destination Y position to write source, can be negative
+ * @param src         source buffer
+ * @param mask        mask buffer, a set bit makes the source bit visible
+ * @param srcWidth    source and mask width
+ * @param srcHeight   source and mask height
+ * @param op          operation to execute on the visible bits
+ */
+template <typename destType, typename srcType>
+void bitblit2dmasked(destType *__restrict__ dest, unsigned int destWidth, unsigned int destHeight, int destX, int destY,
+                     const srcType *__restrict__ src, const srcType *__restrict__ mask, unsigned int srcWidth,
+                     unsigned int srcHeight, bitblitOperation op) noexcept {
+  constexpr unsigned int destDigits = std::numeric_limits<destType>::digits;
+  constexpr unsigned int srcDigits = std::numeric_limits<srcType>::digits;
+  const unsigned int srcStride = ((srcWidth + srcDigits - 1) / srcDigits) * srcDigits;
+  detail::bitblit2dClipped<true>(dest, destWidth / destDigits, destWidth, destHeight, destX, destY, src, srcStride, srcWidth,
+                                 srcHeight, mask, op);
+}
+
+}  // namespace util
+
+#endif
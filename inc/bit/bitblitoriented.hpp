@@ -0,0 +1,338 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2022 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file bitblitoriented.hpp
+ *
+ * 2d bitblit routines that rotate or mirror the source during transfer, for row and page oriented destinations
+ *
+ */
+#ifndef BITBLITORIENTED_HPP
+#define BITBLITORIENTED_HPP
+
+#include <cstdint>
+#include <limits>
+#include <bit/operations.hpp>
+#include <bit/readmodifywrite.hpp>
+#include <bit/bitstream.hpp>
+#include <bit/transpose.hpp>
+
+namespace util {
+namespace detail {
+
+/**
+ * @brief Splits the source in 8 by 8 tiles and reorients them, tiles on the source edges are padded
+ *
+ * @tparam srcType      source element type
+ * @tparam tileFunction callable taking (int x, int y, uint64_t data, uint64_t valid) with the reoriented tile position
+ * relative to the destination origin, its 8 by 8 bits and which of those bits are part of the source
+ * @param src           source buffer
+ * @param srcStride     bits between the start of two source rows
+ * @param srcOrigin     bit index of the first source pixel
+ * @param srcWidth      source width
+ * @param srcHeight     source height
+ * @param orientation   orientation to apply
+ * @param function      called for every tile
+ */
+template <typename srcType, typename tileFunction>
+void forEachOrientedTile(const srcType *__restrict__ src, unsigned int srcStride, unsigned int srcOrigin, unsigned int srcWidth,
+                         unsigned int srcHeight, bitblitOrientation orientation, tileFunction &&function) {
+  const int width = static_cast<int>(srcWidth);
+  const int height = static_cast<int>(srcHeight);
+  for (unsigned int tileY = 0; tileY < srcHeight; tileY += 8) {
+    const unsigned int rows = (srcHeight - tileY) < 8 ? srcHeight - tileY : 8;
+    for (unsigned int tileX = 0; tileX < srcWidth; tileX += 8) {
+      const unsigned int columns = (srcWidth - tileX) < 8 ? srcWidth - tileX : 8;
+      const uint64_t rowMask = lowMask<uint8_t>(columns);
+      uint64_t data = 0;
+      uint64_t valid = 0;
+      for (unsigned int row = 0; row < rows; row++) {
+        const uint64_t rowBits = bitstreamRead<uint8_t>(src, srcOrigin + (tileY + row) * srcStride + tileX, columns);
+        data = data | (rowBits << (8 * row));
+        valid = valid | (rowMask << (8 * row));
+      }
+      // compute where the tile ends up, tiles are always 8 by 8 so partial tiles are aligned to the far edge
+      const int x = static_cast<int>(tileX);
+      const int y = static_cast<int>(tileY);
+      int tileDestX, tileDestY;
+      switch (orientation) {
+        case bitblitOrientation::ORIENT_ROTATE90:
+          tileDestX = height - y - 8;
+          tileDestY = x;
+          break;
+        case bitblitOrientation::ORIENT_ROTATE180:
+          tileDestX = width - x - 8;
+          tileDestY = height - y - 8;
+          break;
+        case bitblitOrientation::ORIENT_ROTATE270:
+          tileDestX = y;
+          tileDestY = width - x - 8;
+          break;
+        case bitblitOrientation::ORIENT_FLIPH:
+          tileDestX = width - x - 8;
+          tileDestY = y;
+          break;
+        case bitblitOrientation::ORIENT_FLIPV:
+          tileDestX = x;
+          tileDestY = height - y - 8;
+          break;
+        case bitblitOrientation::ORIENT_TRANSPOSE:
+          tileDestX = y;
+          tileDestY = x;
+          break;
+        case bitblitOrientation::ORIENT_ANTITRANSPOSE:
+          tileDestX = height - y - 8;
+          tileDestY = width - x - 8;
+          break;
+        default:
+          tileDestX = x;
+          tileDestY = y;
+          break;
+      }
+      function(tileDestX, tileDestY, orient8x8(data, orientation), orient8x8(valid, orientation));
+    }
+  }
+}
+
+/**
+ * @brief Writes up to 8 bits into a destination row, clipped to the row
+ *
+ * @tparam destType destination element type
+ * @param destRow   pointer to the first element of the row
+ * @param destWidth width of the row
+ * @param x         position of the first bit, can be negative
+ * @param bits      bits to write
+ * @param mask      which of the bits to write
+ * @param op        operation to execute
+ */
+template <typename destType>
+void writeRowBits(destType *__restrict__ destRow, unsigned int destWidth, int x, unsigned int bits, unsigned int mask,
+                  bitblitOperation op) noexcept {
+  constexpr unsigned int destDigits = std::numeric_limits<destType>::digits;
+  if (x < 0) {
+    if (x <= -8) return;
+    bits = bits >> -x;
+    mask = mask >> -x;
+    x = 0;
+  }
+  if (x >= static_cast<int>(destWidth)) return;
+  const unsigned int position = static_cast<unsigned int>(x);
+  if ((destWidth - position) < 8) mask = mask & lowMask<uint8_t>(destWidth - position);
+  if (mask == 0) return;
+  destType *currentDest = destRow + position / destDigits;
+  const unsigned int destBit = position % destDigits;
+  destType data = static_cast<destType>(bits << destBit);
+  destType dataMask = static_cast<destType>(mask << destBit);
+  readModifyWrite(currentDest, &data, dataMask, 0, op);
+  if ((destBit + 8) > destDigits) {  // spills over in the next element
+    data = static_cast<destType>(bits >> (destDigits - destBit));
+    dataMask = static_cast<destType>(mask >> (destDigits - destBit));
+    if (dataMask != 0) readModifyWrite(currentDest + 1, &data, dataMask, 0, op);
+  }
+}
+
+/**
+ * @brief Oriented two dimensional block transfer into a row oriented destination, clipped on all edges
+ *
+ * @tparam destType   destination element type
+ * @tparam srcType    source element type
+ * @param dest        destination buffer
+ * @param destStride  elements between the start of two destination rows
+ * @param destWidth   destination width
+ * @param destHeight  destination height
+ * @param destX       destination X position of the reoriented source, can be negative
+ * @param destY       destination Y position of the reoriented source, can be negative
+ * @param src         source buffer
+ * @param srcStride   bits between the start of two source rows
+ * @param srcOrigin   bit index of the first source pixel
+ * @param srcWidth    source width, before reorientation
+ * @param srcHeight   source height, before reorientation
+ * @param orientation orientation to apply
+ * @param op          operation to execute
+ */
+template <typename destType, typename srcType>
+void bitblit2dOrientedClipped(destType *__restrict__ dest, unsigned int destStride, unsigned int destWidth,
+                              unsigned int destHeight, int destX, int destY, const srcType *__restrict__ src,
+                              unsigned int srcStride, unsigned int srcOrigin, unsigned int srcWidth, unsigned int srcHeight,
+                              bitblitOrientation orientation, bitblitOperation op) noexcept {
+  forEachOrientedTile(src, srcStride, srcOrigin, srcWidth, srcHeight, orientation, [&](int x, int y, uint64_t data,
+                                                                                       uint64_t valid) {
+    x = x + destX;
+    y = y + destY;
+    if ((x >= static_cast<int>(destWidth)) || (y >= static_cast<int>(destHeight)) || (x <= -8) || (y <= -8)) return;
+    for (int row = 0; row < 8; row++) {
+      const int currentY = y + row;
+      if ((currentY < 0) || (currentY >= static_cast<int>(destHeight))) continue;
+      writeRowBits(dest + static_cast<unsigned int>(currentY) * destStride, destWidth, x,
+                   static_cast<unsigned int>((data >> (8 * row)) & 0xFF), static_cast<unsigned int>((valid >> (8 * row)) & 0xFF),
+                   op);
+    }
+  });
+}
+
+/**
+ * @brief Oriented two dimensional block transfer into a row oriented destination, source starts at bit 0
+ *
+ */
+template <typename destType, typename srcType>
+void bitblit2dOrientedClipped(destType *__restrict__ dest, unsigned int destStride, unsigned int destWidth,
+                              unsigned int destHeight, int destX, int destY, const srcType *__restrict__ src,
+                              unsigned int srcStride, unsigned int srcWidth, unsigned int srcHeight,
+                              bitblitOrientation orientation, bitblitOperation op) noexcept {
+  bitblit2dOrientedClipped(dest, destStride, destWidth, destHeight, destX, destY, src, srcStride, 0u, srcWidth, srcHeight,
+                           orientation, op);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Two dimensional bit block transfer that rotates or mirrors the source, row oriented destination, with explicit
+ * strides and a source origin
+ *
+ * @tparam destType   destination element type
+ * @tparam srcType    source element type
+ * @param dest        destination buffer
+ * @param destStride  elements between the start of two destination rows
+ * @param destWidth   destination buffer width
+ * @param destHeight  destination buffer height
+ * @param destX       destination X position of the reoriented source, can be negative
+ * @param destY       destination Y position of the reoriented source, can be negative
+ * @param src         source buffer
+ * @param srcStride   bits between the start of two source rows
+ * @param srcX        X position in the source of the block to transfer
+ * @param srcY        Y position in the source of the block to transfer
+ * @param srcWidth    width of the block to transfer
+ * @param srcHeight   height of the block to transfer
+ * @param orientation orientation to apply
+ * @param op          operation to execute
+ */
+template <typename destType, typename srcType>
+void bitblit2doriented(destType *__restrict__ dest, unsigned int destStride, unsigned int destWidth, unsigned int destHeight,
+                       int destX, int destY, const srcType *__restrict__ src, unsigned int srcStride, unsigned int srcX,
+                       unsigned int srcY, unsigned int srcWidth, unsigned int srcHeight, bitblitOrientation orientation,
+                       bitblitOperation op) noexcept {
+  detail::bitblit2dOrientedClipped(dest, destStride, destWidth, destHeight, destX, destY, src, srcStride, srcY * srcStride + srcX,
+                                   srcWidth, srcHeight, orientation, op);
+}
+
+/**
+ * @brief Two dimensional bit block transfer that rotates or mirrors the source, row oriented destination
+ *
+ * Every source row starts on a new source element. The reoriented source is clipped on all four edges of the destination.
+ * When the orientation swaps axes, the reoriented source is srcHeight wide and srcWidth high.
+ *
+ * @tparam destType   destination element type
+ * @tparam srcType    source element type
+ * @param dest        destination buffer
+ * @param destWidth   destination buffer width
+ * @param destHeight  destination buffer height
+ * @param destX       destination X position of the reoriented source, can be negative
+ * @param destY       destination Y position of the reoriented source, can be negative
+ * @param src         source buffer
+ * @param srcWidth    source width
+ * @param srcHeight   source height
+ * @param orientation orientation to apply
+ * @param op          operation to execute
+ */
+template <typename destType, typename srcType>
+void bitblit2doriented(destType *__restrict__ dest, unsigned int destWidth, unsigned int destHeight, int destX, int destY,
+                       const srcType *__restrict__ src, unsigned int srcWidth, unsigned int srcHeight,
+                       bitblitOrientation orientation, bitblitOperation op) noexcept {
+  constexpr unsigned int destDigits = std::numeric_limits<destType>::digits;
+  constexpr unsigned int srcDigits = std::numeric_limits<srcType>::digits;
+  const unsigned int srcStride = ((srcWidth + srcDigits - 1) / srcDigits) * srcDigits;
+  detail::bitblit2dOrientedClipped(dest, destWidth / destDigits, destWidth, destHeight, destX, destY, src, srcStride, srcWidth,
+                                   srcHeight, orientation, op);
+}
+
+/**
+ * @brief Two dimensional bit block transfer from a row oriented source into a page oriented destination, with explicit
+ * strides and a source origin
+ *
+ * @tparam srcType    source element type
+ * @param dest        destination buffer
+ * @param destStride  bytes between the start of two destination pages
+ * @param destWidth   destination buffer width
+ * @param destHeight  destination buffer height, multiple of 8
+ * @param destX       destination X position of the reoriented source, can be negative
+ * @param destY       destination Y position of the reoriented source, can be negative
+ * @param src         source buffer
+ * @param srcStride   bits between the start of two source rows
+ * @param srcX        X position in the source of the block to transfer
+ * @param srcY        Y position in the source of the block to transfer
+ * @param srcWidth    width of the block to transfer
+ * @param srcHeight   height of the block to transfer
+ * @param orientation orientation to apply
+ * @param op          operation to execute
+ */
+template <typename srcType>
+void bitblit2dpaged(uint8_t *__restrict__ dest, unsigned int destStride, unsigned int destWidth, unsigned int destHeight,
+                    int destX, int destY, const srcType *__restrict__ src, unsigned int srcStride, unsigned int srcX,
+                    unsigned int srcY, unsigned int srcWidth, unsigned int srcHeight, bitblitOrientation orientation,
+                    bitblitOperation op) noexcept {
+  const int pageCount = static_cast<int>(destHeight / 8);
+  const unsigned int srcOrigin = srcY * srcStride + srcX;
+  detail::forEachOrientedTile(src, srcStride, srcOrigin, srcWidth, srcHeight, orientation, [&](int x, int y, uint64_t data,
+                                                                                               uint64_t valid) {
+    x = x + destX;
+    y = y + destY;
+    if ((x >= static_cast<int>(destWidth)) || (y >= static_cast<int>(destHeight)) || (x <= -8) || (y <= -8)) return;
+    // pages store columns, transposing the tile turns its rows into columns
+    const uint64_t columns = transpose8x8(data);
+    const uint64_t columnsValid = transpose8x8(valid);
+    const int page = (y >= 0) ? y / 8 : -((7 - y) / 8);
+    const unsigned int shift = static_cast<unsigned int>(y - page * 8);
+    for (int column = 0; column < 8; column++) {
+      const int currentX = x + column;
+      if ((currentX < 0) || (currentX >= static_cast<int>(destWidth))) continue;
+      const unsigned int bits = static_cast<unsigned int>((columns >> (8 * column)) & 0xFF);
+      const unsigned int mask = static_cast<unsigned int>((columnsValid >> (8 * column)) & 0xFF);
+      if ((page >= 0) && (page < pageCount)) {
+        const uint8_t pageBits = static_cast<uint8_t>(bits << shift);
+        readModifyWrite(dest + page * static_cast<int>(destStride) + currentX, &pageBits, static_cast<uint8_t>(mask << shift),
+                        0, op);
+      }
+      if ((shift != 0) && ((page + 1) >= 0) && ((page + 1) < pageCount)) {
+        const uint8_t pageBits = static_cast<uint8_t>(bits >> (8 - shift));
+        readModifyWrite(dest + (page + 1) * static_cast<int>(destStride) + currentX, &pageBits,
+                        static_cast<uint8_t>(mask >> (8 - shift)), 0, op);
+      }
+    }
+  });
+}
+
+/**
+ * @brief Two dimensional bit block transfer from a row oriented source into a page oriented destination
+ *
+ * The destination consists of pages of destWidth bytes, every byte contains 8 vertical pixels with the top pixel in the
+ * least significant bit, like the SSD1306 framebuffer. The source can be rotated or mirrored during the transfer and is
+ * clipped on all four edges of the destination.
+ *
+ * @tparam srcType    source element type
+ * @param dest        destination buffer
+ * @param destWidth   destination buffer width
+ * @param destHeight  destination buffer height, multiple of 8
+ * @param destX       destination X position of the reoriented source, can be negative
+ * @param destY       destination Y position of the reoriented source, can be negative
+ * @param src         source buffer
+ * @param srcWidth    source width
+ * @param srcHeight   source height
+ * @param orientation orientation to apply
+ * @param op          operation to execute
+ */
+template <typename srcType>
+void bitblit2dpaged(uint8_t *__restrict__ dest, unsigned int destWidth, unsigned int destHeight, int destX, int destY,
+                    const srcType *__restrict__ src, unsigned int srcWidth, unsigned int srcHeight, bitblitOrientation orientation,
+                    bitblitOperation op) noexcept {
+  constexpr unsigned int srcDigits = std::numeric_limits<srcType>::digits;
+  const unsigned int srcStride = ((srcWidth + srcDigits - 1) / srcDigits) * srcDigits;
+  bitblit2dpaged(dest, destWidth, destWidth, destHeight, destX, destY, src, srcStride, 0u, 0u, srcWidth, srcHeight, orientation,
+                 op);
+}
+
+}  // namespace util
+
+#endif
@@ -0,0 +1,330 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file bitblitreference.hpp
+ *
+ * Trivially correct pixel at a time bitblit, used as reference when verifying the optimized blitters
+ *
+ */
+#ifndef BITBLITREFERENCE_HPP
+#define BITBLITREFERENCE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <bit/operations.hpp>
+
+namespace util {
+namespace reference {
+
+/**
+ * @brief Reads a pixel from a row oriented bitmap, bit 0 of an element is the leftmost pixel
+ *
+ * @tparam T      element type
+ * @param buffer  bitmap
+ * @param stride  bits between the start of two rows
+ * @param x       X position
+ * @param y       Y position
+ * @return true   pixel is set
+ */
+template <typename T>
+bool getPixel(const T *buffer, unsigned int stride, unsigned int x, unsigned int y) noexcept {
+  constexpr unsigned int digits = std::numeric_limits<T>::digits;
+  const unsigned int bit = y * stride + x;
+  return ((buffer[bit / digits] >> (bit % digits)) & 1) != 0;
+}
+
+/**
+ * @brief Writes a pixel in a row oriented bitmap, bit 0 of an element is the leftmost pixel
+ *
+ * @tparam T      element type
+ * @param buffer  bitmap
+ * @param stride  bits between the start of two rows
+ * @param x       X position
+ * @param y       Y position
+ * @param pixel   value to write
+ */
+template <typename T>
+void setPixel(T *buffer, unsigned int stride, unsigned int x, unsigned int y, bool pixel) noexcept {
+  constexpr unsigned int digits = std::numeric_limits<T>::digits;
+  const unsigned int bit = y * stride + x;
+  const T mask = static_cast<T>(static_cast<T>(1) << (bit % digits));
+  if (pixel)
+    buffer[bit / digits] = buffer[bit / digits] | mask;
+  else
+    buffer[bit / digits] = static_cast<T>(buffer[bit / digits] & ~mask);
+}
+
+/**
+ * @brief Applies a blit operation to a single pixel
+ *
+ * @param op    operation
+ * @param dest  destination pixel
+ * @param src   source pixel
+ * @return bool resulting pixel
+ */
+constexpr bool applyOperation(bitblitOperation op, bool dest, bool src) noexcept {
+  switch (op) {
+    case bitblitOperation::OP_MOV:
+      return src;
+    case bitblitOperation::OP_NOT:
+      return !src;
+    case bitblitOperation::OP_AND:
+      return dest && src;
+    case bitblitOperation::OP_OR:
+      return dest || src;
+    case bitblitOperation::OP_XOR:
+      return dest != src;
+  }
+  return dest;
+}
+
+/**
+ * @brief Two dimensional bit block transfer, one pixel at a time, clipped on all four edges of the destination
+ *
+ * @tparam destType   destination element type
+ * @tparam srcType    source element type
+ * @param dest        destination buffer
+ * @param destStride  elements between the start of two destination rows
+ * @param destWidth   destination width
+ * @param destHeight  destination height
+ * @param destX       destination X position, can be negative
+ * @param destY       destination Y position, can be negative
+ * @param src         source buffer
+ * @param srcStride   bits between the start of two source rows
+ * @param srcX        X position in the source of the block to transfer
+ * @param srcY        Y position in the source of the block to transfer
+ * @param srcWidth    width of the block to transfer
+ * @param srcHeight   height of the block to transfer
+ * @param mask        mask with the same layout as the source, nullptr transfers all pixels
+ * @param op          operation to execute
+ */
+template <typename destType, typename srcType>
+void bitblit2d(destType *dest, unsigned int destStride, unsigned int destWidth, unsigned int destHeight, int destX, int destY,
+               const srcType *src, unsigned int srcStride, unsigned int srcX, unsigned int srcY, unsigned int srcWidth,
+               unsigned int srcHeight, const srcType *mask, bitblitOperation op) noexcept {
+  const unsigned int destBitStride = destStride * std::numeric_limits<destType>::digits;
+  for (unsigned int y = 0; y < srcHeight; y++) {
+    const int currentY = destY + static_cast<int>(y);
+    if ((currentY < 0) || (currentY >= static_cast<int>(destHeight))) continue;
+    for (unsigned int x = 0; x < srcWidth; x++) {
+      const int currentX = destX + static_cast<int>(x);
+      if ((currentX < 0) || (currentX >= static_cast<int>(destWidth))) continue;
+      if ((mask != nullptr) && !getPixel(mask, srcStride, srcX + x, srcY + y)) continue;
+      const unsigned int px = static_cast<unsigned int>(currentX);
+      const unsigned int py = static_cast<unsigned int>(currentY);
+      setPixel(dest, destBitStride, px, py,
+               applyOperation(op, getPixel(dest, destBitStride, px, py), getPixel(src, srcStride, srcX + x, srcY + y)));
+    }
+  }
+}
+
+/**
+ * @brief Reads a pixel from a page oriented bitmap, every byte holds 8 vertical pixels with the top one in bit 0
+ *
+ * @param buffer  bitmap
+ * @param stride  bytes between the start of two pages
+ * @param x       X position
+ * @param y       Y position
+ * @return true   pixel is set
+ */
+inline bool getPagedPixel(const uint8_t *buffer, unsigned int stride, unsigned int x, unsigned int y) noexcept {
+  return ((buffer[(y / 8) * stride + x] >> (y % 8)) & 1) != 0;
+}
+
+/**
+ * @brief Writes a pixel in a page oriented bitmap, every byte holds 8 vertical pixels with the top one in bit 0
+ *
+ * @param buffer  bitmap
+ * @param stride  bytes between the start of two pages
+ * @param x       X position
+ * @param y       Y position
+ * @param pixel   value to write
+ */
+inline void setPagedPixel(uint8_t *buffer, unsigned int stride, unsigned int x, unsigned int y, bool pixel) noexcept {
+  const uint8_t mask = static_cast<uint8_t>(1 << (y % 8));
+  uint8_t &element = buffer[(y / 8) * stride + x];
+  element = pixel ? static_cast<uint8_t>(element | mask) : static_cast<uint8_t>(element & ~mask);
+}
+
+/**
+ * @brief Position of a source pixel after reorientation, rotations are clockwise
+ *
+ * @param orientation orientation to apply
+ * @param width       source width, before reorientation
+ * @param height      source height, before reorientation
+ * @param x           X position in the source
+ * @param y           Y position in the source
+ * @param orientedX   X position in the reoriented source
+ * @param orientedY   Y position in the reoriented source
+ */
+inline void orientPosition(bitblitOrientation orientation, int width, int height, int x, int y, int &orientedX,
+                           int &orientedY) noexcept {
+  switch (orientation) {
+    case bitblitOrientation::ORIENT_ROTATE90:
+      orientedX = height - 1 - y;
+      orientedY = x;
+      break;
+    case bitblitOrientation::ORIENT_ROTATE180:
+      orientedX = width - 1 - x;
+      orientedY = height - 1 - y;
+      break;
+    case bitblitOrientation::ORIENT_ROTATE270:
+      orientedX = y;
+      orientedY = width - 1 - x;
+      break;
+    case bitblitOrientation::ORIENT_FLIPH:
+      orientedX = width - 1 - x;
+      orientedY = y;
+      break;
+    case bitblitOrientation::ORIENT_FLIPV:
+      orientedX = x;
+      orientedY = height - 1 - y;
+      break;
+    case bitblitOrientation::ORIENT_TRANSPOSE:
+      orientedX = y;
+      orientedY = x;
+      break;
+    case bitblitOrientation::ORIENT_ANTITRANSPOSE:
+      orientedX = height - 1 - y;
+      orientedY = width - 1 - x;
+      break;
+    default:
+      orientedX = x;
+      orientedY = y;
+      break;
+  }
+}
+
+/**
+ * @brief Oriented two dimensional bit block transfer, one pixel at a time, clipped on all four edges of the destination
+ *
+ * The source block is reoriented before it is placed at destX, destY.
+ *
+ * @tparam paged        destination is page oriented
+ * @tparam destType     destination element type, uint8_t for a paged destination
+ * @tparam srcType      source element type
+ * @param dest          destination buffer
+ * @param destStride    elements between the start of two destination rows or pages
+ * @param destWidth     destination width
+ * @param destHeight    destination height
+ * @param destX         destination X position of the reoriented block, can be negative
+ * @param destY         destination Y position of the reoriented block, can be negative
+ * @param src           source buffer
+ * @param srcStride     bits between the start of two source rows
+ * @param srcX          X position in the source of the block to transfer
+ * @param srcY          Y position in the source of the block to transfer
+ * @param srcWidth      width of the block to transfer, before reorientation
+ * @param srcHeight     height of the block to transfer, before reorientation
+ * @param orientation   orientation to apply
+ * @param op            operation to execute
+ */
+template <bool paged, typename destType, typename srcType>
+void bitblit2doriented(destType *dest, unsigned int destStride, unsigned int destWidth, unsigned int destHeight, int destX,
+                       int destY, const srcType *src, unsigned int srcStride, unsigned int srcX, unsigned int srcY,
+                       unsigned int srcWidth, unsigned int srcHeight, bitblitOrientation orientation,
+                       bitblitOperation op) noexcept {
+  const unsigned int destBitStride = destStride * std::numeric_limits<destType>::digits;
+  for (unsigned int y = 0; y < srcHeight; y++) {
+    for (unsigned int x = 0; x < srcWidth; x++) {
+      int orientedX, orientedY;
+      orientPosition(orientation, static_cast<int>(srcWidth), static_cast<int>(srcHeight), static_cast<int>(x),
+                     static_cast<int>(y), orientedX, orientedY);
+      const int currentX = destX + orientedX;
+      const int currentY = destY + orientedY;
+      if ((currentX < 0) || (currentX >= static_cast<int>(destWidth))) continue;
+      if ((currentY < 0) || (currentY >= static_cast<int>(destHeight))) continue;
+      const unsigned int px = static_cast<unsigned int>(currentX);
+      const unsigned int py = static_cast<unsigned int>(currentY);
+      const bool pixel = getPixel(src, srcStride, srcX + x, srcY + y);
+      if constexpr (paged)
+        setPagedPixel(dest, destStride, px, py, applyOperation(op, getPagedPixel(dest, destStride, px, py), pixel));
+      else
+        setPixel(dest, destBitStride, px, py, applyOperation(op, getPixel(dest, destBitStride, px, py), pixel));
+    }
+  }
+}
+
+/**
+ * @brief Fills a rectangle with a pattern, one pixel at a time, clipped on all four edges of the destination
+ *
+ * A row oriented destination takes one pattern element per row, bit n of the element is used for every destination X
+ * position n modulo the element size. A paged destination takes one pattern byte per column, bit n of the byte is used for
+ * every destination Y position n modulo 8. Nothing is filled for an empty pattern.
+ *
+ * @tparam paged        destination is page oriented
+ * @tparam destType     destination element type, uint8_t for a paged destination
+ * @param dest          destination buffer
+ * @param destStride    elements between the start of two destination rows or pages
+ * @param destWidth     destination width
+ * @param destHeight    destination height
+ * @param x             X position of the rectangle, can be negative
+ * @param y             Y position of the rectangle, can be negative
+ * @param width         width of the rectangle
+ * @param height        height of the rectangle
+ * @param pattern       pattern elements
+ * @param patternLength amount of pattern elements
+ * @param op            operation to execute
+ */
+template <bool paged, typename destType>
+void fillRect(destType *dest, unsigned int destStride, unsigned int destWidth, unsigned int destHeight, int x, int y,
+              unsigned int width, unsigned int height, const destType *pattern, unsigned int patternLength,
+              bitblitOperation op) noexcept {
+  constexpr unsigned int digits = std::numeric_limits<destType>::digits;
+  if (patternLength == 0) return;
+  const unsigned int destBitStride = destStride * digits;
+  for (int currentY = y; currentY < y + static_cast<int>(height); currentY++) {
+    if ((currentY < 0) || (currentY >= static_cast<int>(destHeight))) continue;
+    for (int currentX = x; currentX < x + static_cast<int>(width); currentX++) {
+      if ((currentX < 0) || (currentX >= static_cast<int>(destWidth))) continue;
+      const unsigned int px = static_cast<unsigned int>(currentX);
+      const unsigned int py = static_cast<unsigned int>(currentY);
+      if constexpr (paged) {
+        const bool pixel = ((pattern[px % patternLength] >> (py % 8)) & 1) != 0;
+        setPagedPixel(dest, destStride, px, py, applyOperation(op, getPagedPixel(dest, destStride, px, py), pixel));
+      } else {
+        const bool pixel = ((pattern[py % patternLength] >> (px % digits)) & 1) != 0;
+        setPixel(dest, destBitStride, px, py, applyOperation(op, getPixel(dest, destBitStride, px, py), pixel));
+      }
+    }
+  }
+}
+
+/**
+ * @brief Compares the pixels of two row oriented bitmaps
+ *
+ * Bits beyond the width up to the stride are compared as well, so writes outside of the destination width are caught.
+ *
+ * @tparam T        element type
+ * @param a         first bitmap
+ * @param b         second bitmap
+ * @param stride    elements between the start of two rows
+ * @param height    bitmap height
+ * @param mismatchX X position of the first mismatching pixel, only written on mismatch
+ * @param mismatchY Y position of the first mismatching pixel, only written on mismatch
+ * @return true     bitmaps are equal
+ */
+template <typename T>
+bool compare(const T *a, const T *b, unsigned int stride, unsigned int height, unsigned int &mismatchX,
+             unsigned int &mismatchY) noexcept {
+  const unsigned int bitStride = stride * std::numeric_limits<T>::digits;
+  for (unsigned int y = 0; y < height; y++) {
+    for (unsigned int x = 0; x < bitStride; x++) {
+      if (getPixel(a, bitStride, x, y) != getPixel(b, bitStride, x, y)) {
+        mismatchX = x;
+        mismatchY = y;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace reference
+}  // namespace util
+
+#endif
@@ -0,0 +1,201 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2022 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file bitstream.hpp
+ *
+ * Helpers to treat element arrays as a continuous stream of bits, used by the word level blitters
+ *
+ */
+#ifndef BITSTREAM_HPP
+#define BITSTREAM_HPP
+
+#include <limits>
+#include <bit/operations.hpp>
+#include <bit/readmodifywrite.hpp>
+#include <bit/simd.hpp>
+
+namespace util {
+namespace detail {
+
+/**
+ * @brief Computes a mask with the lower bits set
+ *
+ * @tparam T        element type of the mask
+ * @param bitCount  amount of lower bits to set, can be equal to the amount of bits in T
+ * @return T        mask with bitCount lower bits set
+ */
+template <typename T>
+constexpr T lowMask(unsigned int bitCount) noexcept {
+  if (bitCount >= static_cast<unsigned int>(std::numeric_limits<T>::digits)) return std::numeric_limits<T>::max();
+  return static_cast<T>((static_cast<T>(1) << bitCount) - 1);
+}
+
+/**
+ * @brief Reads bits from a bitstream, the first bit of the stream is the least significant bit of the first element
+ *
+ * @tparam wordType type to return the bits in
+ * @tparam srcType  source element type
+ * @param src       pointer to the start of the bitstream
+ * @param bitIndex  index of the first bit to read
+ * @param bitCount  amount of bits to read, maximum is the amount of bits in wordType
+ * @return wordType bits read, first bit read is put in the least significant bit
+ */
+template <typename wordType, typename srcType>
+wordType bitstreamRead(const srcType *__restrict__ src, unsigned int bitIndex, unsigned int bitCount) noexcept {
+  constexpr unsigned int srcDigits = std::numeric_limits<srcType>::digits;
+  src = src + (bitIndex / srcDigits);
+  unsigned int srcBit = bitIndex % srcDigits;
+  unsigned int resultBit = 0;
+  wordType result = 0;
+  while (resultBit < bitCount) {
+    unsigned int chunk = srcDigits - srcBit;
+    if (chunk > (bitCount - resultBit)) chunk = bitCount - resultBit;
+    wordType bits = static_cast<wordType>(*src >> srcBit) & lowMask<wordType>(chunk);
+    result = result | static_cast<wordType>(bits << resultBit);
+    resultBit += chunk;
+    srcBit = 0;
+    src++;
+  }
+  return result;
+}
+
+/**
+ * @brief Transfers a single row of bits into destination, a whole destination element at a time
+ *
+ * @tparam masked   when true, the mask bitstream selects which destination bits are written
+ * @tparam destType destination element type
+ * @tparam srcType  source element type
+ * @param destRow   pointer to the first element of the destination row
+ * @param destBegin first destination bit to write
+ * @param destEnd   one beyond the last destination bit to write
+ * @param src       source bitstream
+ * @param srcBit    bit index in the source bitstream that maps onto destBegin
+ * @param mask      mask bitstream, indexed the same as the source, only used when masked is true
+ * @param op        operation to execute
+ */
+template <bool masked, typename destType, typename srcType>
+void blitRowElements(destType *__restrict__ destRow, unsigned int destBegin, unsigned int destEnd,
+                     const srcType *__restrict__ src, unsigned int srcBit, const srcType *__restrict__ mask,
+                     bitblitOperation op) noexcept {
+  constexpr unsigned int destDigits = std::numeric_limits<destType>::digits;
+  destType *currentDest = destRow + (destBegin / destDigits);
+  while (destBegin < destEnd) {
+    const unsigned int destBit = destBegin % destDigits;
+    unsigned int count = destDigits - destBit;
+    if (count > (destEnd - destBegin)) count = destEnd - destBegin;
+    const destType data = static_cast<destType>(bitstreamRead<destType>(src, srcBit, count) << destBit);
+    destType dataMask = static_cast<destType>(lowMask<destType>(count) << destBit);
+    if constexpr (masked) dataMask = dataMask & static_cast<destType>(bitstreamRead<destType>(mask, srcBit, count) << destBit);
+    readModifyWrite(currentDest, &data, dataMask, 0, op);
+    destBegin += count;
+    srcBit += count;
+    currentDest++;
+  }
+}
+
+/**
+ * @brief Transfers a single row of bits into destination
+ *
+ * On little endian hosts with SIMD support, the whole bytes of an unmasked row are transferred with the vectorized row
+ * transfer, the bit order within a row is then the same as for byte rows. Otherwise the row is transferred a whole
+ * destination element at a time.
+ *
+ * @tparam masked   when true, the mask bitstream selects which destination bits are written
+ * @tparam destType destination element type
+ * @tparam srcType  source element type
+ * @param destRow   pointer to the first element of the destination row
+ * @param destBegin first destination bit to write
+ * @param destEnd   one beyond the last destination bit to write
+ * @param src       source bitstream
+ * @param srcBit    bit index in the source bitstream that maps onto destBegin
+ * @param mask      mask bitstream, indexed the same as the source, only used when masked is true
+ * @param op        operation to execute
+ */
+template <bool masked, typename destType, typename srcType>
+void blitRow(destType *__restrict__ destRow, unsigned int destBegin, unsigned int destEnd, const srcType *__restrict__ src,
+             unsigned int srcBit, const srcType *__restrict__ mask, bitblitOperation op) noexcept {
+#if BITBLIT_SIMD
+  if constexpr (!masked) {
+    const unsigned int firstByte = (destBegin + 7) / 8;
+    const unsigned int lastByte = destEnd / 8;
+    if ((lastByte > firstByte) && ((lastByte - firstByte) >= 16)) {
+      // destination bit p receives source bit p - delta, split delta in whole bytes and a bit shift
+      const unsigned int srcBegin = srcBit + (firstByte * 8 - destBegin);
+      const unsigned int shift = (8 - (srcBegin % 8)) % 8;
+      const uint8_t *srcBytes = reinterpret_cast<const uint8_t *>(src) + (srcBegin + shift) / 8;
+      blitRowElements<masked>(destRow, destBegin, firstByte * 8, src, srcBit, mask, op);
+      rowTransfer(reinterpret_cast<uint8_t *>(destRow) + firstByte, srcBytes, lastByte - firstByte, shift, op);
+      blitRowElements<masked>(destRow, lastByte * 8, destEnd, src, srcBit + (lastByte * 8 - destBegin), mask, op);
+      return;
+    }
+  }
+#endif
+  blitRowElements<masked>(destRow, destBegin, destEnd, src, srcBit, mask, op);
+}
+
+/**
+ * @brief Two dimensional clipped block transfer, clips on all four edges of the destination
+ *
+ * @tparam masked     when true, the mask bitmap selects which destination bits are written
+ * @tparam destType   destination element type
+ * @tparam srcType    source element type
+ * @param dest        destination buffer
+ * @param destStride  elements between the start of two destination rows
+ * @param destWidth   destination width in bits
+ * @param destHeight  destination height in bits
+ * @param destX       destination X position to write source, can be negative
+ * @param destY       destination Y position to write source, can be negative
+ * @param src         source buffer
+ * @param srcStride   bits between the start of two source rows
+ * @param srcOrigin   bit index of the first source pixel, used for blitting out of a larger source bitmap
+ * @param srcWidth    source width in bits
+ * @param srcHeight   source height in bits
+ * @param mask        mask buffer, same layout as source, only used when masked is true
+ * @param op          operation to execute
+ */
+template <bool masked, typename destType, typename srcType>
+void bitblit2dClipped(destType *__restrict__ dest, unsigned int destStride, unsigned int destWidth, unsigned int destHeight,
+                      int destX, int destY, const srcType *__restrict__ src, unsigned int srcStride, unsigned int srcOrigin,
+                      unsigned int srcWidth, unsigned int srcHeight, const srcType *__restrict__ mask,
+                      bitblitOperation op) noexcept {
+  // clip on all edges, signed arithmetic so negative origins are handled
+  int beginX = destX < 0 ? 0 : destX;
+  int beginY = destY < 0 ? 0 : destY;
+  int endX = destX + static_cast<int>(srcWidth);
+  int endY = destY + static_cast<int>(srcHeight);
+  if (endX > static_cast<int>(destWidth)) endX = static_cast<int>(destWidth);
+  if (endY > static_cast<int>(destHeight)) endY = static_cast<int>(destHeight);
+  if ((beginX >= endX) || (beginY >= endY)) return;  // nothing visible
+
+  unsigned int srcBit =
+      srcOrigin + static_cast<unsigned int>(beginX - destX) + static_cast<unsigned int>(beginY - destY) * srcStride;
+  dest = dest + static_cast<unsigned int>(beginY) * destStride;
+  int heightCounter = endY - beginY;
+  while (heightCounter > 0) {
+    blitRow<masked>(dest, static_cast<unsigned int>(beginX), static_cast<unsigned int>(endX), src, srcBit, mask, op);
+    dest = dest + destStride;
+    srcBit = srcBit + srcStride;
+    heightCounter--;
+  }
+}
+
+/**
+ * @brief Two dimensional clipped block transfer, clips on all four edges of the destination, source starts at bit 0
+ *
+ */
+template <bool masked, typename destType, typename srcType>
+void bitblit2dClipped(destType *__restrict__ dest, unsigned int destStride, unsigned int destWidth, unsigned int destHeight,
+                      int destX, int destY, const srcType *__restrict__ src, unsigned int srcStride, unsigned int srcWidth,
+                      unsigned int srcHeight, const srcType *__restrict__ mask, bitblitOperation op) noexcept {
+  bitblit2dClipped<masked>(dest, destStride, destWidth, destHeight, destX, destY, src, srcStride, 0u, srcWidth, srcHeight, mask,
+                           op);
+}
+
+}  // namespace detail
+}  // namespace util
+
+#endif
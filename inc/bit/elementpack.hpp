@@ -13,7 +13,9 @@
 #ifndef ELEMENT_PACK_H
 #define ELEMENT_PACK_H
 
+#include <cstddef>
 #include <limits>
+#include <span>
 #include <bit/operations.hpp>
 #include <bit/readmodifywrite.hpp>
 
@@ -21,7 +23,8 @@ namespace util {
 /**
  * @brief puts the bits of the source into destination
  *
- * When using a larger destination then source, source is stepped through to completely fill destination
+ * When using a larger destination then source, source is stepped through to completely fill destination. When using a smaller
+ * destination then source, one source element is spread over multiple destination elements, most significant bits first.
  *
  * @tparam destType Destination element type
  * @tparam srcType  Source element type
@@ -94,9 +97,79 @@ void elementPack(destType *__restrict__ dest, const srcType *__restrict__ src, i
       }
     }
   }
-  // cant handle this, yet
-  else
-    static_assert(destDigits >= srcDigits, "elementPack can only pack if source is smaller or equally sized then destination");
+  // dest smaller then source
+  else {
+    static_assert((srcDigits % destDigits) == 0, "elementPack source bits should be a multiple of destination bits");
+    constexpr int elementCount = srcDigits / destDigits;
+    // window of the source bitstream that ends up in destination, first bit is the most significant bit
+    srcType window;
+    srcType windowMask = std::numeric_limits<srcType>::max();
+    if (srcShift >= srcDigits) {
+      window = src[1];
+    } else if (srcShift > 0) {
+      window = static_cast<srcType>(static_cast<srcType>(*src << srcShift) | static_cast<srcType>(src[1] >> (srcDigits - srcShift)));
+    } else if (srcShift <= -srcDigits) {
+      return;  // shifted out completely
+    } else if (srcShift < 0) {
+      window = static_cast<srcType>(*src >> -srcShift);
+      windowMask = static_cast<srcType>(windowMask >> -srcShift);
+    } else {
+      window = *src;
+    }
+    for (int i = 0; i < elementCount; i++) {
+      const int shiftpos = srcDigits - destDigits * (i + 1);
+      const destType data = static_cast<destType>(window >> shiftpos);
+      const destType destMask = static_cast<destType>(windowMask >> shiftpos);
+      if (destMask != 0) readModifyWrite(dest + i, &data, destMask, 0, op);
+    }
+  }
+}
+
+/**
+ * @brief packs a row of source elements into a row of destination elements
+ *
+ * Bits are packed in the same order as elementPack, the first source element ends up in the most significant bits when
+ * widening and the most significant bits of a source element end up in the first destination element when narrowing.
+ * When widening and the source does not fill the last destination element, only its upper bits are written.
+ *
+ * @tparam destType Destination element type
+ * @tparam srcType  Source element type
+ * @param dest      destination elements
+ * @param src       source elements
+ * @param op        operation to execute
+ * @return size_t   amount of destination elements written
+ */
+template <typename destType, typename srcType>
+size_t elementPackSpan(std::span<destType> dest, std::span<const srcType> src, bitblitOperation op) noexcept {
+  constexpr size_t destDigits = std::numeric_limits<destType>::digits;
+  constexpr size_t srcDigits = std::numeric_limits<srcType>::digits;
+  if constexpr (destDigits == srcDigits) {
+    const size_t count = dest.size() < src.size() ? dest.size() : src.size();
+    for (size_t i = 0; i < count; i++) readModifyWrite(&dest[i], &src[i], std::numeric_limits<destType>::max(), 0, op);
+    return count;
+  } else if constexpr (destDigits > srcDigits) {
+    constexpr size_t ratio = destDigits / srcDigits;
+    size_t count = src.size() / ratio;
+    if (count > dest.size()) count = dest.size();
+    for (size_t i = 0; i < count; i++) elementPack(&dest[i], &src[i * ratio], 0, op);
+    const size_t remainder = src.size() - count * ratio;
+    if ((remainder == 0) || (count == dest.size())) return count;
+    // partially filled last destination element
+    destType destMask = static_cast<destType>(std::numeric_limits<srcType>::max()) << (destDigits - srcDigits);
+    int shiftpos = static_cast<int>(destDigits - srcDigits);
+    for (size_t i = 0; i < remainder; i++) {
+      readModifyWrite(&dest[count], &src[count * ratio + i], destMask, shiftpos, op);
+      destMask = destMask >> srcDigits;
+      shiftpos -= static_cast<int>(srcDigits);
+    }
+    return count + 1;
+  } else {
+    constexpr size_t ratio = srcDigits / destDigits;
+    size_t count = dest.size() / ratio;
+    if (count > src.size()) count = src.size();
+    for (size_t i = 0; i < count; i++) elementPack(&dest[i * ratio], &src[i], 0, op);
+    return count * ratio;
+  }
 }
 }  // namespace util
 
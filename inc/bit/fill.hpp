@@ -0,0 +1,313 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2022 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file fill.hpp
+ *
+ * rectangle and pattern fill routines, for row oriented and page oriented framebuffers
+ *
+ */
+#ifndef FILL_HPP
+#define FILL_HPP
+
+#include <limits>
+#include <cstdint>
+#include <bit/operations.hpp>
+#include <bit/readmodifywrite.hpp>
+#include <bit/bitstream.hpp>
+
+namespace util {
+namespace detail {
+
+/**
+ * @brief Applies a value to consecutive whole elements, operation is decoded once for all elements
+ *
+ * @tparam destType destination element type
+ * @param dest      pointer to the first element
+ * @param count     amount of elements
+ * @param value     value to apply to every element
+ * @param op        operation to execute
+ */
+template <typename destType>
+void fillElements(destType *__restrict__ dest, unsigned int count, destType value, bitblitOperation op) noexcept {
+  switch (op) {
+    case bitblitOperation::OP_AND:
+      while (count-- > 0) *dest++ &= value;
+      break;
+    case bitblitOperation::OP_MOV:
+      while (count-- > 0) *dest++ = value;
+      break;
+    case bitblitOperation::OP_NOT:
+      value = static_cast<destType>(~value);
+      while (count-- > 0) *dest++ = value;
+      break;
+    case bitblitOperation::OP_OR:
+      while (count-- > 0) *dest++ |= value;
+      break;
+    case bitblitOperation::OP_XOR:
+      while (count-- > 0) *dest++ ^= value;
+      break;
+  }
+}
+
+/**
+ * @brief Fills a range of bits in a row, interior elements are written whole, only the edges are masked
+ *
+ * @tparam destType destination element type
+ * @param destRow   pointer to the first element of the row
+ * @param destBegin first bit to fill
+ * @param destEnd   one beyond the last bit to fill
+ * @param value     value to fill with, is aligned to the destination elements
+ * @param op        operation to execute
+ */
+template <typename destType>
+void fillRow(destType *__restrict__ destRow, unsigned int destBegin, unsigned int destEnd, destType value,
+             bitblitOperation op) noexcept {
+  constexpr unsigned int destDigits = std::numeric_limits<destType>::digits;
+  destType *currentDest = destRow + (destBegin / destDigits);
+  const unsigned int beginBit = destBegin % destDigits;
+  const unsigned int lastElement = (destEnd - 1) / destDigits;
+  const unsigned int firstElement = destBegin / destDigits;
+  if (firstElement == lastElement) {  // begin and end in the same element
+    const destType mask = static_cast<destType>(lowMask<destType>(destEnd - destBegin) << beginBit);
+    readModifyWrite(currentDest, &value, mask, 0, op);
+    return;
+  }
+  unsigned int count = lastElement - firstElement - 1;
+  if (beginBit != 0) {  // partial first element
+    const destType mask = static_cast<destType>(std::numeric_limits<destType>::max() << beginBit);
+    readModifyWrite(currentDest, &value, mask, 0, op);
+    currentDest++;
+  } else {
+    count++;
+  }
+  fillElements(currentDest, count, value, op);
+  currentDest += count;
+  // last element, can be full
+  const destType mask = lowMask<destType>(destEnd - lastElement * destDigits);
+  readModifyWrite(currentDest, &value, mask, 0, op);
+}
+
+/**
+ * @brief Clips a rectangle against the destination
+ *
+ * @return true when some part of the rectangle remains
+ */
+inline bool clipRect(unsigned int destWidth, unsigned int destHeight, int x, int y, unsigned int width, unsigned int height,
+                     unsigned int &beginX, unsigned int &beginY, unsigned int &endX, unsigned int &endY) noexcept {
+  int clipBeginX = x < 0 ? 0 : x;
+  int clipBeginY = y < 0 ? 0 : y;
+  int clipEndX = x + static_cast<int>(width);
+  int clipEndY = y + static_cast<int>(height);
+  if (clipEndX > static_cast<int>(destWidth)) clipEndX = static_cast<int>(destWidth);
+  if (clipEndY > static_cast<int>(destHeight)) clipEndY = static_cast<int>(destHeight);
+  if ((clipBeginX >= clipEndX) || (clipBeginY >= clipEndY)) return false;
+  beginX = static_cast<unsigned int>(clipBeginX);
+  beginY = static_cast<unsigned int>(clipBeginY);
+  endX = static_cast<unsigned int>(clipEndX);
+  endY = static_cast<unsigned int>(clipEndY);
+  return true;
+}
+
+/**
+ * @brief Fills a clipped rectangle in a row oriented framebuffer with a pattern
+ *
+ * @tparam destType     destination element type
+ * @param dest          destination buffer
+ * @param destStride    elements between the start of two destination rows
+ * @param destWidth     destination width in bits
+ * @param destHeight    destination height in bits
+ * @param x             X position of the rectangle, can be negative
+ * @param y             Y position of the rectangle, can be negative
+ * @param width         width of the rectangle
+ * @param height        height of the rectangle
+ * @param pattern       one element per pattern row, repeated horizontally and aligned to the destination elements
+ * @param patternHeight amount of pattern rows, the pattern is aligned to destination row 0, nothing is filled when 0
+ * @param op            operation to execute
+ */
+template <typename destType>
+void fillRectClipped(destType *__restrict__ dest, unsigned int destStride, unsigned int destWidth, unsigned int destHeight,
+                     int x, int y, unsigned int width, unsigned int height, const destType *__restrict__ pattern,
+                     unsigned int patternHeight, bitblitOperation op) noexcept {
+  unsigned int beginX, beginY, endX, endY;
+  if (patternHeight == 0) return;
+  if (!clipRect(destWidth, destHeight, x, y, width, height, beginX, beginY, endX, endY)) return;
+  dest = dest + beginY * destStride;
+  unsigned int patternRow = beginY % patternHeight;
+  for (unsigned int row = beginY; row < endY; row++) {
+    fillRow(dest, beginX, endX, pattern[patternRow], op);
+    dest = dest + destStride;
+    patternRow++;
+    if (patternRow == patternHeight) patternRow = 0;
+  }
+}
+
+/**
+ * @brief Fills a clipped rectangle in a page oriented framebuffer with a pattern
+ *
+ * @param dest          destination buffer, every byte contains 8 vertical pixels, pages of destWidth bytes
+ * @param destWidth     destination width in pixels
+ * @param destHeight    destination height in pixels
+ * @param x             X position of the rectangle, can be negative
+ * @param y             Y position of the rectangle, can be negative
+ * @param width         width of the rectangle
+ * @param height        height of the rectangle
+ * @param pattern       one byte per pattern column, every byte contains 8 vertical pixels, aligned to the pages
+ * @param patternWidth  amount of pattern columns, the pattern is aligned to destination column 0, nothing is filled when 0
+ * @param op            operation to execute
+ */
+inline void fillRectPagedClipped(uint8_t *__restrict__ dest, unsigned int destWidth, unsigned int destHeight, int x, int y,
+                                 unsigned int width, unsigned int height, const uint8_t *__restrict__ pattern,
+                                 unsigned int patternWidth, bitblitOperation op) noexcept {
+  unsigned int beginX, beginY, endX, endY;
+  if (patternWidth == 0) return;
+  if (!clipRect(destWidth, destHeight, x, y, width, height, beginX, beginY, endX, endY)) return;
+  const unsigned int lastPage = (endY - 1) / 8;
+  for (unsigned int page = beginY / 8; page <= lastPage; page++) {
+    const unsigned int pageBegin = page * 8 < beginY ? beginY - page * 8 : 0;
+    const unsigned int pageEnd = (page * 8 + 8) > endY ? endY - page * 8 : 8;
+    const uint8_t mask = static_cast<uint8_t>(lowMask<uint8_t>(pageEnd - pageBegin) << pageBegin);
+    uint8_t *currentDest = dest + page * destWidth + beginX;
+    if ((mask == 0xFF) && (patternWidth == 1)) {  // whole bytes of a solid pattern
+      fillElements(currentDest, endX - beginX, pattern[0], op);
+      continue;
+    }
+    unsigned int patternColumn = beginX % patternWidth;
+    for (unsigned int column = beginX; column < endX; column++) {
+      readModifyWrite(currentDest, &pattern[patternColumn], mask, 0, op);
+      currentDest++;
+      patternColumn++;
+      if (patternColumn == patternWidth) patternColumn = 0;
+    }
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Fills a rectangle in a row oriented framebuffer
+ *
+ * @tparam destType   destination element type
+ * @param dest        destination buffer
+ * @param destWidth   destination buffer width
+ * @param destHeight  destination buffer height
+ * @param x           X position of the rectangle, can be negative
+ * @param y           Y position of the rectangle, can be negative
+ * @param width       width of the rectangle
+ * @param height      height of the rectangle
+ * @param set         true sets all bits in the rectangle, false clears them
+ */
+template <typename destType>
+void fillRect(destType *__restrict__ dest, unsigned int destWidth, unsigned int destHeight, int x, int y, unsigned int width,
+              unsigned int height, bool set) noexcept {
+  constexpr unsigned int destDigits = std::numeric_limits<destType>::digits;
+  const destType value = set ? std::numeric_limits<destType>::max() : 0;
+  detail::fillRectClipped(dest, destWidth / destDigits, destWidth, destHeight, x, y, width, height, &value, 1,
+                          bitblitOperation::OP_MOV);
+}
+
+/**
+ * @brief Inverts a rectangle in a row oriented framebuffer
+ *
+ * @tparam destType   destination element type
+ * @param dest        destination buffer
+ * @param destWidth   destination buffer width
+ * @param destHeight  destination buffer height
+ * @param x           X position of the rectangle, can be negative
+ * @param y           Y position of the rectangle, can be negative
+ * @param width       width of the rectangle
+ * @param height      height of the rectangle
+ */
+template <typename destType>
+void invertRect(destType *__restrict__ dest, unsigned int destWidth, unsigned int destHeight, int x, int y, unsigned int width,
+                unsigned int height) noexcept {
+  constexpr unsigned int destDigits = std::numeric_limits<destType>::digits;
+  const destType value = std::numeric_limits<destType>::max();
+  detail::fillRectClipped(dest, destWidth / destDigits, destWidth, destHeight, x, y, width, height, &value, 1,
+                          bitblitOperation::OP_XOR);
+}
+
+/**
+ * @brief Fills a rectangle in a row oriented framebuffer with a repeating pattern
+ *
+ * @tparam destType     destination element type
+ * @param dest          destination buffer
+ * @param destWidth     destination buffer width
+ * @param destHeight    destination buffer height
+ * @param x             X position of the rectangle, can be negative
+ * @param y             Y position of the rectangle, can be negative
+ * @param width         width of the rectangle
+ * @param height        height of the rectangle
+ * @param pattern       one element per pattern row, repeated horizontally and aligned to the destination elements
+ * @param patternHeight amount of pattern rows
+ * @param op            operation to execute
+ */
+template <typename destType>
+void patternFill(destType *__restrict__ dest, unsigned int destWidth, unsigned int destHeight, int x, int y,
+                 unsigned int width, unsigned int height, const destType *__restrict__ pattern, unsigned int patternHeight,
+                 bitblitOperation op) noexcept {
+  constexpr unsigned int destDigits = std::numeric_limits<destType>::digits;
+  detail::fillRectClipped(dest, destWidth / destDigits, destWidth, destHeight, x, y, width, height, pattern, patternHeight, op);
+}
+
+/**
+ * @brief Fills a rectangle in a page oriented framebuffer
+ *
+ * @param dest        destination buffer, every byte contains 8 vertical pixels
+ * @param destWidth   destination buffer width
+ * @param destHeight  destination buffer height
+ * @param x           X position of the rectangle, can be negative
+ * @param y           Y position of the rectangle, can be negative
+ * @param width       width of the rectangle
+ * @param height      height of the rectangle
+ * @param set         true sets all bits in the rectangle, false clears them
+ */
+inline void fillRectPaged(uint8_t *__restrict__ dest, unsigned int destWidth, unsigned int destHeight, int x, int y,
+                          unsigned int width, unsigned int height, bool set) noexcept {
+  const uint8_t value = set ? 0xFF : 0x00;
+  detail::fillRectPagedClipped(dest, destWidth, destHeight, x, y, width, height, &value, 1, bitblitOperation::OP_MOV);
+}
+
+/**
+ * @brief Inverts a rectangle in a page oriented framebuffer
+ *
+ * @param dest        destination buffer, every byte contains 8 vertical pixels
+ * @param destWidth   destination buffer width
+ * @param destHeight  destination buffer height
+ * @param x           X position of the rectangle, can be negative
+ * @param y           Y position of the rectangle, can be negative
+ * @param width       width of the rectangle
+ * @param height      height of the rectangle
+ */
+inline void invertRectPaged(uint8_t *__restrict__ dest, unsigned int destWidth, unsigned int destHeight, int x, int y,
+                            unsigned int width, unsigned int height) noexcept {
+  const uint8_t value = 0xFF;
+  detail::fillRectPagedClipped(dest, destWidth, destHeight, x, y, width, height, &value, 1, bitblitOperation::OP_XOR);
+}
+
+/**
+ * @brief Fills a rectangle in a page oriented framebuffer with a repeating pattern
+ *
+ * @param dest          destination buffer, every byte contains 8 vertical pixels
+ * @param destWidth     destination buffer width
+ * @param destHeight    destination buffer height
+ * @param x             X position of the rectangle, can be negative
+ * @param y             Y position of the rectangle, can be negative
+ * @param width         width of the rectangle
+ * @param height        height of the rectangle
+ * @param pattern       one byte per pattern column, every byte contains 8 vertical pixels
+ * @param patternWidth  amount of pattern columns
+ * @param op            operation to execute
+ */
+inline void patternFillPaged(uint8_t *__restrict__ dest, unsigned int destWidth, unsigned int destHeight, int x, int y,
+                             unsigned int width, unsigned int height, const uint8_t *__restrict__ pattern,
+                             unsigned int patternWidth, bitblitOperation op) noexcept {
+  detail::fillRectPagedClipped(dest, destWidth, destHeight, x, y, width, height, pattern, patternWidth, op);
+}
+
+}  // namespace util
+
+#endif
@@ -19,6 +19,21 @@ namespace util {
  *
  */
 enum class bitblitOperation { OP_MOV, OP_NOT, OP_AND, OP_OR, OP_XOR };
+
+/**
+ * @brief orientations a source can be transferred with, rotations are clockwise
+ *
+ */
+enum class bitblitOrientation {
+  ORIENT_NORMAL,         /*!< source is transferred as is */
+  ORIENT_ROTATE90,       /*!< source is rotated 90 degrees */
+  ORIENT_ROTATE180,      /*!< source is rotated 180 degrees */
+  ORIENT_ROTATE270,      /*!< source is rotated 270 degrees */
+  ORIENT_FLIPH,          /*!< source is mirrored horizontally */
+  ORIENT_FLIPV,          /*!< source is mirrored vertically */
+  ORIENT_TRANSPOSE,      /*!< source is mirrored around the main diagonal */
+  ORIENT_ANTITRANSPOSE,  /*!< source is mirrored around the anti diagonal */
+};
 }  // namespace util
 
 #endif
\ No newline at end of file
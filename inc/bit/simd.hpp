@@ -0,0 +1,172 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2022 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file simd.hpp
+ *
+ * Byte row transfer used by the bitblit interiors, with SSE2 and AVX2 versions for hosts
+ *
+ */
+#ifndef BIT_SIMD_HPP
+#define BIT_SIMD_HPP
+
+#include <cstdint>
+#include <bit/operations.hpp>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Set to 1 when the row transfer is vectorized, element rows can then be treated as byte rows on little endian hosts
+ *
+ */
+#if (defined(__AVX2__) || defined(__SSE2__)) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define BITBLIT_SIMD 1
+#else
+#define BITBLIT_SIMD 0
+#endif
+
+namespace util {
+namespace detail {
+
+template <bitblitOperation op>
+inline uint8_t applyOperation(uint8_t dest, uint8_t src) noexcept {
+  switch (op) {
+    case bitblitOperation::OP_NOT:
+      return static_cast<uint8_t>(~src);
+    case bitblitOperation::OP_AND:
+      return dest & src;
+    case bitblitOperation::OP_OR:
+      return dest | src;
+    case bitblitOperation::OP_XOR:
+      return dest ^ src;
+    default:
+      return src;
+  }
+}
+
+#if defined(__AVX2__)
+template <bitblitOperation op>
+inline __m256i applyOperation(__m256i dest, __m256i src) noexcept {
+  switch (op) {
+    case bitblitOperation::OP_NOT:
+      return _mm256_xor_si256(src, _mm256_set1_epi8(-1));
+    case bitblitOperation::OP_AND:
+      return _mm256_and_si256(dest, src);
+    case bitblitOperation::OP_OR:
+      return _mm256_or_si256(dest, src);
+    case bitblitOperation::OP_XOR:
+      return _mm256_xor_si256(dest, src);
+    default:
+      return src;
+  }
+}
+#endif
+
+#if defined(__SSE2__)
+template <bitblitOperation op>
+inline __m128i applyOperation(__m128i dest, __m128i src) noexcept {
+  switch (op) {
+    case bitblitOperation::OP_NOT:
+      return _mm_xor_si128(src, _mm_set1_epi8(-1));
+    case bitblitOperation::OP_AND:
+      return _mm_and_si128(dest, src);
+    case bitblitOperation::OP_OR:
+      return _mm_or_si128(dest, src);
+    case bitblitOperation::OP_XOR:
+      return _mm_xor_si128(dest, src);
+    default:
+      return src;
+  }
+}
+#endif
+
+template <bitblitOperation op>
+void rowTransfer(uint8_t *__restrict__ dest, const uint8_t *__restrict__ src, unsigned int count, unsigned int shift) noexcept {
+  unsigned int i = 0;
+  // there are no byte shifts, shift 16 bit lanes and mask off the bits that crossed a byte boundary
+#if defined(__AVX2__)
+  {
+    const __m128i left = _mm_cvtsi32_si128(static_cast<int>(shift));
+    const __m128i right = _mm_cvtsi32_si128(static_cast<int>(8 - shift));
+    const __m256i leftMask = _mm256_set1_epi8(static_cast<char>(0xFF << shift));
+    const __m256i rightMask = _mm256_set1_epi8(static_cast<char>(0xFF >> (8 - shift)));
+    for (; (i + 32) <= count; i += 32) {
+      __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+      if (shift != 0) {
+        const __m256i previous = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i - 1));
+        data = _mm256_or_si256(_mm256_and_si256(_mm256_sll_epi16(data, left), leftMask),
+                               _mm256_and_si256(_mm256_srl_epi16(previous, right), rightMask));
+      }
+      __m256i *destVector = reinterpret_cast<__m256i *>(dest + i);
+      _mm256_storeu_si256(destVector, applyOperation<op>(_mm256_loadu_si256(destVector), data));
+    }
+  }
+#endif
+#if defined(__SSE2__)
+  {
+    const __m128i left = _mm_cvtsi32_si128(static_cast<int>(shift));
+    const __m128i right = _mm_cvtsi32_si128(static_cast<int>(8 - shift));
+    const __m128i leftMask = _mm_set1_epi8(static_cast<char>(0xFF << shift));
+    const __m128i rightMask = _mm_set1_epi8(static_cast<char>(0xFF >> (8 - shift)));
+    for (; (i + 16) <= count; i += 16) {
+      __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+      if (shift != 0) {
+        const __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i - 1));
+        data = _mm_or_si128(_mm_and_si128(_mm_sll_epi16(data, left), leftMask),
+                            _mm_and_si128(_mm_srl_epi16(previous, right), rightMask));
+      }
+      __m128i *destVector = reinterpret_cast<__m128i *>(dest + i);
+      _mm_storeu_si128(destVector, applyOperation<op>(_mm_loadu_si128(destVector), data));
+    }
+  }
+#endif
+  for (; i < count; i++) {
+    uint8_t data = src[i];
+    if (shift != 0) data = static_cast<uint8_t>((data << shift) | (*(src + i - 1) >> (8 - shift)));
+    dest[i] = applyOperation<op>(dest[i], data);
+  }
+}
+
+/**
+ * @brief Transfers whole bytes of a row, byte i of destination receives source byte i shifted left by shift bits, with
+ * the upper bits of source byte i - 1 shifted in
+ *
+ * Equivalent to a readModifyWrite of every destination byte with a full mask. When shift is not zero, the byte before the
+ * source is read.
+ *
+ * @param dest    destination bytes
+ * @param src     source bytes
+ * @param count   amount of destination bytes to write
+ * @param shift   bit shift between source and destination, 0 to 7
+ * @param op      operation to execute
+ */
+inline void rowTransfer(uint8_t *__restrict__ dest, const uint8_t *__restrict__ src, unsigned int count, unsigned int shift,
+                        bitblitOperation op) noexcept {
+  switch (op) {
+    case bitblitOperation::OP_MOV:
+      rowTransfer<bitblitOperation::OP_MOV>(dest, src, count, shift);
+      break;
+    case bitblitOperation::OP_NOT:
+      rowTransfer<bitblitOperation::OP_NOT>(dest, src, count, shift);
+      break;
+    case bitblitOperation::OP_AND:
+      rowTransfer<bitblitOperation::OP_AND>(dest, src, count, shift);
+      break;
+    case bitblitOperation::OP_OR:
+      rowTransfer<bitblitOperation::OP_OR>(dest, src, count, shift);
+      break;
+    case bitblitOperation::OP_XOR:
+      rowTransfer<bitblitOperation::OP_XOR>(dest, src, count, shift);
+      break;
+  }
+}
+
+}  // namespace detail
+}  // namespace util
+
+#endif
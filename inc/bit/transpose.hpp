@@ -0,0 +1,124 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2022 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file transpose.hpp
+ *
+ * bit matrix transpose and bit reversal routines, inspired by the transpose routines in Hacker's Delight
+ *
+ */
+#ifndef TRANSPOSE_HPP
+#define TRANSPOSE_HPP
+
+#include <cstdint>
+#include <limits>
+#include <bit/operations.hpp>
+#include <bit/bitstream.hpp>
+
+namespace util {
+
+/**
+ * @brief Transposes an 8 by 8 bit matrix
+ *
+ * Row r of the matrix is byte r of the input, column c is bit c of that byte. Bit c of row r ends up as bit r of row c.
+ *
+ * @param matrix  8 by 8 bit matrix
+ * @return uint64_t transposed matrix
+ */
+constexpr uint64_t transpose8x8(uint64_t matrix) noexcept {
+  uint64_t t;
+  t = (matrix ^ (matrix >> 7)) & 0x00AA00AA00AA00AAull;
+  matrix = matrix ^ t ^ (t << 7);
+  t = (matrix ^ (matrix >> 14)) & 0x0000CCCC0000CCCCull;
+  matrix = matrix ^ t ^ (t << 14);
+  t = (matrix ^ (matrix >> 28)) & 0x00000000F0F0F0F0ull;
+  matrix = matrix ^ t ^ (t << 28);
+  return matrix;
+}
+
+/**
+ * @brief Transposes a square bit matrix in place
+ *
+ * The matrix has as many rows as the row type has bits, bit c of row r ends up as bit r of row c. With uint16_t rows
+ * this is a 16 by 16 transpose.
+ *
+ * @tparam T    row type, must be unsigned
+ * @param rows  matrix rows
+ */
+template <typename T>
+void transposeSquare(T (&rows)[std::numeric_limits<T>::digits]) noexcept {
+  static_assert(!std::numeric_limits<T>::is_signed, "transposeSquare only accepts unsigned types!");
+  constexpr unsigned int size = std::numeric_limits<T>::digits;
+  unsigned int j = size / 2;
+  T mask = detail::lowMask<T>(j);
+  while (j != 0) {
+    for (unsigned int k = 0; k < size; k = (k + j + 1) & ~j) {
+      const T t = static_cast<T>(((rows[k] >> j) ^ rows[k + j]) & mask);
+      rows[k] = static_cast<T>(rows[k] ^ (t << j));
+      rows[k + j] = static_cast<T>(rows[k + j] ^ t);
+    }
+    j = j / 2;
+    mask = static_cast<T>(mask ^ (mask << j));
+  }
+}
+
+/**
+ * @brief Reverses the bit order in every byte of an 8 by 8 bit matrix, mirrors it horizontally
+ *
+ * @param matrix  8 by 8 bit matrix
+ * @return uint64_t mirrored matrix
+ */
+constexpr uint64_t mirror8x8(uint64_t matrix) noexcept {
+  matrix = ((matrix >> 1) & 0x5555555555555555ull) | ((matrix & 0x5555555555555555ull) << 1);
+  matrix = ((matrix >> 2) & 0x3333333333333333ull) | ((matrix & 0x3333333333333333ull) << 2);
+  matrix = ((matrix >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((matrix & 0x0F0F0F0F0F0F0F0Full) << 4);
+  return matrix;
+}
+
+/**
+ * @brief Reverses the row order of an 8 by 8 bit matrix, flips it vertically
+ *
+ * @param matrix  8 by 8 bit matrix
+ * @return uint64_t flipped matrix
+ */
+constexpr uint64_t flip8x8(uint64_t matrix) noexcept {
+  matrix = ((matrix >> 8) & 0x00FF00FF00FF00FFull) | ((matrix & 0x00FF00FF00FF00FFull) << 8);
+  matrix = ((matrix >> 16) & 0x0000FFFF0000FFFFull) | ((matrix & 0x0000FFFF0000FFFFull) << 16);
+  matrix = (matrix >> 32) | (matrix << 32);
+  return matrix;
+}
+
+/**
+ * @brief Reorients an 8 by 8 bit matrix
+ *
+ * @param matrix      8 by 8 bit matrix
+ * @param orientation orientation to apply
+ * @return uint64_t   reoriented matrix
+ */
+constexpr uint64_t orient8x8(uint64_t matrix, bitblitOrientation orientation) noexcept {
+  switch (orientation) {
+    case bitblitOrientation::ORIENT_ROTATE90:
+      return mirror8x8(transpose8x8(matrix));
+    case bitblitOrientation::ORIENT_ROTATE180:
+      return flip8x8(mirror8x8(matrix));
+    case bitblitOrientation::ORIENT_ROTATE270:
+      return flip8x8(transpose8x8(matrix));
+    case bitblitOrientation::ORIENT_FLIPH:
+      return mirror8x8(matrix);
+    case bitblitOrientation::ORIENT_FLIPV:
+      return flip8x8(matrix);
+    case bitblitOrientation::ORIENT_TRANSPOSE:
+      return transpose8x8(matrix);
+    case bitblitOrientation::ORIENT_ANTITRANSPOSE:
+      return flip8x8(mirror8x8(transpose8x8(matrix)));
+    default:
+      return matrix;
+  }
+}
+
+}  // namespace util
+
+#endif
@@ -20,6 +20,8 @@
 #include <bit/bitblit1d.hpp>
 #include <bit/bitblit2dfast.hpp>
 #include <bit/bitblit2dsmall.hpp>
+#include <bit/bitblitmasked.hpp>
+#include <bit/bitblitoriented.hpp>
 
 namespace util {
 
@@ -39,6 +41,51 @@ namespace util {
 void bitblit2d(__restrict uint8_t *dest, unsigned int destWidth, unsigned int destHeight, unsigned int destX, unsigned int destY,
                __restrict const uint8_t *src, unsigned int srcWidth, unsigned int srcHeight, bitblitOperation op) noexcept;
 
+/**
+ * @brief Two dimensional bit block transfer with an explicit source stride
+ *
+ * The source is read as a continuous bitstream, row r starts at bit r * srcStride. With srcStride equal to srcWidth the
+ * source rows are fully packed without padding, which saves space for odd width fonts and icons.
+ *
+ * @param dest        destination buffer
+ * @param destWidth   destination buffer width
+ * @param destHeight  destination buffer height
+ * @param destX       destination X position to write source
+ * @param destY       destination Y position to write source
+ * @param src         source buffer
+ * @param srcStride   bits between the start of two source rows
+ * @param srcWidth    source width
+ * @param srcHeight   source height
+ * @param op          operation to execute
+ */
+void bitblit2d(__restrict uint8_t *dest, unsigned int destWidth, unsigned int destHeight, unsigned int destX, unsigned int destY,
+               __restrict const uint8_t *src, unsigned int srcStride, unsigned int srcWidth, unsigned int srcHeight,
+               bitblitOperation op) noexcept;
+
+/**
+ * @brief Two dimensional bit block transfer with explicit strides and a source origin
+ *
+ * The destination stride allows framebuffers with out of band data between rows, the source origin allows transferring
+ * blocks out of sprite sheets. Row r of the source bitmap starts at bit r * srcStride.
+ *
+ * @param dest        destination buffer
+ * @param destStride  bytes between the start of two destination rows
+ * @param destWidth   destination buffer width
+ * @param destHeight  destination buffer height
+ * @param destX       destination X position to write source
+ * @param destY       destination Y position to write source
+ * @param src         source buffer
+ * @param srcStride   bits between the start of two source rows
+ * @param srcX        X position in the source of the block to transfer
+ * @param srcY        Y position in the source of the block to transfer
+ * @param srcWidth    width of the block to transfer
+ * @param srcHeight   height of the block to transfer
+ * @param op          operation to execute
+ */
+void bitblit2d(__restrict uint8_t *dest, unsigned int destStride, unsigned int destWidth, unsigned int destHeight,
+               unsigned int destX, unsigned int destY, __restrict const uint8_t *src, unsigned int srcStride, unsigned int srcX,
+               unsigned int srcY, unsigned int srcWidth, unsigned int srcHeight, bitblitOperation op) noexcept;
+
 };  // namespace util
 
 #endif
\ No newline at end of file
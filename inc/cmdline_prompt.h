@@ -33,13 +33,20 @@ extern "C" {
 #include <datastream.h>
 
 /* pass stringqueue to commandline prompt */
-void cmdlinePromptInit(const t_queueString *q);
+void cmdlinePromptInit(t_queueString *q);
 /*
 Every call the stream will be checked for a single character, if present it will be parsed.
 When some characters need to be returned, they will be output via stream.
 When a full commandline is input, calls cmdlineParse to interpret command.
 */
 result cmdlinePromptProcess(const datastreamChar_t *stream, result (*cmdlineParse)(char *cmdline));
+/*
+Processes characters until the stream is empty or maxCharacters have been processed, for use after a notification.
+Returns noError when the limit was reached and characters can be left, otherwise the result of the read that stopped
+processing.
+*/
+result cmdlinePromptProcessBatch(const datastreamChar_t *stream, result (*cmdlineParse)(char *cmdline),
+                                 unsigned int maxCharacters);
 
 #ifdef __cplusplus
 }
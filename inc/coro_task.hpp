@@ -0,0 +1,335 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file coro_task.hpp
+ *
+ * C++20 coroutine tasks with coroutine frames from a static pool, an alternative to the sq_coro.hpp macros that keeps
+ * local variables across suspension points and supports multiple instances of the same coroutine function
+ *
+ */
+#ifndef CORO_TASK_HPP
+#define CORO_TASK_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <coroutine>
+#include <exception>
+#include <span>
+#include <datastream.h>
+#include <pool.hpp>
+
+namespace util {
+
+/**
+ * @brief Static pool of coroutine frames, every task type draws its frames from a pool type
+ *
+ * The frame size a coroutine needs is only known to the compiler, when a frame does not fit the task creation fails and
+ * the returned task is not valid. Use statistics to size the pool.
+ *
+ * @tparam frameSize  maximum size of a coroutine frame in bytes
+ * @tparam frameCount amount of frames, the maximum amount of coroutines alive at the same time
+ */
+template <size_t frameSize, size_t frameCount>
+struct coroFramePool {
+  /**
+   * @brief Allocates a coroutine frame
+   *
+   * @param size    size requested by the compiler
+   * @return void*  frame, nullptr when the frame does not fit or the pool is empty
+   */
+  static void *allocate(size_t size) noexcept {
+    if (size > frameSize) return nullptr;
+    return pool.allocate();
+  }
+
+  /**
+   * @brief Returns a coroutine frame to the pool
+   *
+   * @param frame frame to return
+   */
+  static void deallocate(void *frame) noexcept {
+    pool.deallocate(frame);
+  }
+
+  /**
+   * @brief Usage statistics of the frame pool
+   *
+   * @return poolStatistics usage statistics
+   */
+  static poolStatistics statistics() noexcept {
+    return pool.statistics();
+  }
+
+  inline static blockPool<frameSize, frameCount> pool; /**< frame storage */
+};
+
+/**
+ * @brief Coroutine task that is resumed by polling, without heap or scheduler
+ *
+ * A task starts suspended. Every poll checks if the awaitable the task waits on is ready and if so resumes the task until
+ * its next suspension point. Example:
+ *
+ *   using framePool = util::coroFramePool<128, 4>;
+ *   util::coTask<framePool> echo(const datastreamChar_t *stream) {
+ *     while (true) {
+ *       char c;
+ *       co_await util::readChar(stream, c);
+ *       co_await util::writeChar(stream, c);
+ *     }
+ *   }
+ *
+ *   auto task = echo(&uart);
+ *   while (task.poll()) {
+ *   }
+ *
+ * @tparam framePool pool to allocate the coroutine frames from, see coroFramePool
+ */
+template <typename framePool>
+class coTask {
+ public:
+  /**
+   * @brief Promise of the task, holds what the task waits on
+   *
+   */
+  struct promise_type {
+    coTask get_return_object() noexcept {
+      return coTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+
+    static coTask get_return_object_on_allocation_failure() noexcept {
+      return coTask{};
+    }
+
+    std::suspend_always initial_suspend() noexcept {
+      return {};
+    }
+
+    std::suspend_always final_suspend() noexcept {
+      return {};
+    }
+
+    void return_void() noexcept {}
+
+    void unhandled_exception() noexcept {
+      std::terminate();
+    }
+
+    static void *operator new(size_t size) noexcept {
+      return framePool::allocate(size);
+    }
+
+    static void operator delete(void *frame) noexcept {
+      framePool::deallocate(frame);
+    }
+
+    bool (*waitReady)(void *) = nullptr; /**< checks if the awaited operation is ready, nullptr when not waiting */
+    void *waitObject = nullptr;          /**< awaitable the task waits on */
+  };
+
+  coTask() noexcept = default;
+
+  coTask(coTask &&other) noexcept : handle{other.handle} {
+    other.handle = nullptr;
+  }
+
+  coTask &operator=(coTask &&other) noexcept {
+    if (this != &other) {
+      if (handle) handle.destroy();
+      handle = other.handle;
+      other.handle = nullptr;
+    }
+    return *this;
+  }
+
+  coTask(const coTask &) = delete;
+  coTask &operator=(const coTask &) = delete;
+
+  ~coTask() {
+    if (handle) handle.destroy();
+  }
+
+  /**
+   * @brief Resumes the task when what it waits on is ready
+   *
+   * @return true   task is not done yet
+   * @return false  task is done or not valid
+   */
+  bool poll() {
+    if (!handle || handle.done()) return false;
+    promise_type &promise = handle.promise();
+    if ((promise.waitReady != nullptr) && !promise.waitReady(promise.waitObject)) return true;
+    promise.waitReady = nullptr;
+    handle.resume();
+    return !handle.done();
+  }
+
+  /**
+   * @brief Checks if the task got a coroutine frame
+   *
+   * @return true   task can run
+   * @return false  frame allocation failed
+   */
+  bool valid() const noexcept {
+    return static_cast<bool>(handle);
+  }
+
+  /**
+   * @brief Checks if the task has finished
+   *
+   * @return true   task is done or not valid
+   */
+  bool done() const noexcept {
+    return !handle || handle.done();
+  }
+
+ private:
+  explicit coTask(std::coroutine_handle<promise_type> newHandle) noexcept : handle{newHandle} {}
+
+  std::coroutine_handle<promise_type> handle = nullptr; /**< coroutine owned by the task */
+};
+
+/**
+ * @brief Base of awaitables that are polled by the task, derived classes implement ready and await_resume
+ *
+ * ready is called once when awaiting and on every poll of the task while suspended, the operation is started or retried
+ * by ready and the task is resumed when it returns true.
+ *
+ * @tparam derived awaitable type with a bool ready() member
+ */
+template <typename derived>
+struct pollAwaitable {
+  bool await_ready() {
+    return static_cast<derived *>(this)->ready();
+  }
+
+  template <typename promise>
+  void await_suspend(std::coroutine_handle<promise> handle) noexcept {
+    handle.promise().waitReady = [](void *object) { return static_cast<derived *>(object)->ready(); };
+    handle.promise().waitObject = static_cast<derived *>(this);
+  }
+};
+
+/**
+ * @brief Waits until a condition is true
+ *
+ * @tparam predicate callable returning bool
+ */
+template <typename predicate>
+struct until : pollAwaitable<until<predicate>> {
+  explicit until(predicate condition) : condition{condition} {}
+
+  bool ready() {
+    return condition();
+  }
+
+  void await_resume() noexcept {}
+
+  predicate condition; /**< condition to wait for */
+};
+
+/**
+ * @brief Waits until an amount of ticks has passed on a clock, for example the util::scheduler or a systick counter
+ *
+ * @tparam clock type with a uint32_t time() member
+ */
+template <typename clock>
+struct delay : pollAwaitable<delay<clock>> {
+  delay(const clock &timeSource, uint32_t ticks) : timeSource{timeSource}, start{timeSource.time()}, ticks{ticks} {}
+
+  bool ready() {
+    return (timeSource.time() - start) >= ticks;
+  }
+
+  void await_resume() noexcept {}
+
+  const clock &timeSource; /**< clock to wait on */
+  uint32_t start;          /**< time the wait started */
+  uint32_t ticks;          /**< ticks to wait */
+};
+
+/**
+ * @brief Reads a character from a datastream, waits while the stream is empty
+ *
+ * The result of the read is returned by co_await, errors other then an empty stream end the wait.
+ */
+struct readChar : pollAwaitable<readChar> {
+  readChar(const datastreamChar_t *stream, char &c) : stream{stream}, c{c} {}
+
+  bool ready() {
+    status = dsReadChar(stream, &c);
+    return (status != streamEmtpy) && (status != queueEmpty);
+  }
+
+  result await_resume() noexcept {
+    return status;
+  }
+
+  const datastreamChar_t *stream; /**< stream to read from */
+  char &c;                        /**< destination of the character */
+  result status = noError;        /**< result of the last read attempt */
+};
+
+/**
+ * @brief Writes a character to a datastream, waits while the stream is full
+ *
+ * The result of the write is returned by co_await, errors other then a full stream end the wait.
+ */
+struct writeChar : pollAwaitable<writeChar> {
+  writeChar(const datastreamChar_t *stream, char c) : stream{stream}, c{c} {}
+
+  bool ready() {
+    status = dsWriteChar(stream, c);
+    return (status != streamFull) && (status != queueFull);
+  }
+
+  result await_resume() noexcept {
+    return status;
+  }
+
+  const datastreamChar_t *stream; /**< stream to write to */
+  char c;                         /**< character to write */
+  result status = noError;        /**< result of the last write attempt */
+};
+
+/**
+ * @brief Transmits data over SPI and waits until the peripheral is done
+ *
+ * The transfer starts when awaited. Peripherals with a busy() member, like an interrupt or DMA driven SPI, are polled
+ * until done; blocking peripherals such as the SPI mock complete immediately.
+ *
+ * @tparam spiType      SPI peripheral with a transmit member like the SPI mock
+ * @tparam chipEnables  chip enable type of the peripheral
+ */
+template <typename spiType, typename chipEnables>
+struct spiTransmit : pollAwaitable<spiTransmit<spiType, chipEnables>> {
+  spiTransmit(spiType &peripheral, chipEnables device, std::span<uint16_t> buffer, uint16_t bitcount, bool lastAction)
+      : peripheral{peripheral}, device{device}, buffer{buffer}, bitcount{bitcount}, lastAction{lastAction} {}
+
+  bool ready() {
+    if (!started) {
+      peripheral.transmit(device, buffer, bitcount, lastAction);
+      started = true;
+    }
+    if constexpr (requires(spiType &p) { p.busy(); })
+      return !peripheral.busy();
+    else
+      return true;
+  }
+
+  void await_resume() noexcept {}
+
+  spiType &peripheral;         /**< peripheral to transmit with */
+  chipEnables device;          /**< device to transmit to */
+  std::span<uint16_t> buffer;  /**< data to transmit */
+  uint16_t bitcount;           /**< amount of bits to transmit */
+  bool lastAction;             /**< disable the chip select after the transfer */
+  bool started = false;        /**< transfer has been started */
+};
+
+}  // namespace util
+
+#endif
@@ -0,0 +1,62 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file datastream_notify.h
+ *
+ * Notification of datastream consumers when data arrives, so they do not have to poll an empty stream
+ *
+ * The producer of a stream, for example a UART receive interrupt, calls dsNotify after adding data. The consumer either
+ * registers a callback, for example one signalling a scheduler event, or checks dsNotifyTake from its main loop. After
+ * a notification the consumer drains the stream, the batch functions of the prompts process a bounded amount of
+ * characters per wakeup and report if data is left.
+ *
+ */
+#ifndef DATASTREAM_NOTIFY_H
+#define DATASTREAM_NOTIFY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct datastreamNotifier {
+  void (*callback)(void *context); /**< called on every notification, NULL when not used */
+  void *context;                   /**< passed to the callback */
+  volatile bool pending;           /**< set on notification, cleared by dsNotifyTake */
+} datastreamNotifier_t;
+
+/**
+ * @brief Initializes a notifier
+ *
+ * @param notifier notifier to initialize
+ * @param callback called on every notification, can be NULL
+ * @param context  passed to the callback
+ */
+void dsNotifyInit(datastreamNotifier_t *notifier, void (*callback)(void *context), void *context);
+
+/**
+ * @brief Notifies the consumer that data is available, call from the producer after adding data
+ *
+ * @param notifier notifier of the stream
+ */
+void dsNotify(datastreamNotifier_t *notifier);
+
+/**
+ * @brief Takes a pending notification, clear before draining the stream so no notification is lost
+ *
+ * @param notifier notifier of the stream
+ * @return true when a notification was pending
+ */
+bool dsNotifyTake(datastreamNotifier_t *notifier);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,413 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file displaylist.hpp
+ *
+ * Retained display list of draw commands, executed band by band into a small strip buffer
+ *
+ */
+#ifndef DISPLAYLIST_HPP
+#define DISPLAYLIST_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <array.hpp>
+#include <bitblit.hpp>
+#include <bit/fill.hpp>
+#include <fonts/font.hpp>
+
+namespace util {
+
+/**
+ * @brief draw commands a display list can contain
+ *
+ */
+enum class displayCommandType : uint8_t { blit, fill, text };
+
+/**
+ * @brief single draw command, positions and sizes are in pixels
+ *
+ */
+struct displayCommand {
+  const void *data;               /*!< bitmap for blit, string for text */
+  const font *textFont;           /*!< font used for text */
+  int16_t x;                      /*!< X position */
+  int16_t y;                      /*!< Y position */
+  uint16_t width;                 /*!< width of the drawn area */
+  uint16_t height;                /*!< height of the drawn area */
+  uint16_t srcWidth;              /*!< bitmap width before reorientation */
+  uint16_t srcHeight;             /*!< bitmap height before reorientation */
+  displayCommandType type;        /*!< what to draw */
+  bitblitOperation op;            /*!< operation to draw with */
+  bitblitOrientation orientation; /*!< orientation of the bitmap */
+};
+
+/**
+ * @brief Display list with a fixed amount of commands
+ *
+ * Commands are recorded instead of drawn directly. When rendering, commands are sorted on their top position and executed
+ * band by band into a strip buffer that only needs to hold a few lines. Commands are always executed in the order they were
+ * added, so overlapping commands give the same result as drawing directly into a full framebuffer.
+ *
+ * @tparam N maximum amount of commands
+ */
+template <size_t N>
+class displayList {
+ public:
+  static_assert(N > 0, "display list size of zero is not allowed!");
+  static_assert(N <= std::numeric_limits<uint16_t>::max(), "display list too large!");
+
+  displayList() {
+    reset();
+  }
+
+  /**
+   * @brief Removes all commands
+   *
+   */
+  void reset() {
+    count = 0;
+  }
+
+  /**
+   * @brief Amount of commands in the list
+   *
+   * @return size_t amount of commands
+   */
+  size_t size() const {
+    return count;
+  }
+
+  /**
+   * @brief Adds a bitmap transfer, the bitmap must stay valid until rendering is done
+   *
+   * @param x           X position, can be negative
+   * @param y           Y position, can be negative
+   * @param bitmap      row oriented bitmap, every row starts on a new byte
+   * @param width       bitmap width
+   * @param height      bitmap height
+   * @param orientation orientation to transfer the bitmap with
+   * @param op          operation to draw with
+   * @return true       command added
+   * @return false      display list is full
+   */
+  bool blit(int x, int y, const uint8_t *bitmap, unsigned int width, unsigned int height, bitblitOrientation orientation,
+            bitblitOperation op) {
+    displayCommand *command = add();
+    if (command == nullptr) return false;
+    const bool swapped = (orientation == bitblitOrientation::ORIENT_ROTATE90) ||
+                         (orientation == bitblitOrientation::ORIENT_ROTATE270) ||
+                         (orientation == bitblitOrientation::ORIENT_TRANSPOSE) ||
+                         (orientation == bitblitOrientation::ORIENT_ANTITRANSPOSE);
+    *command = {bitmap,
+                nullptr,
+                static_cast<int16_t>(x),
+                static_cast<int16_t>(y),
+                static_cast<uint16_t>(swapped ? height : width),
+                static_cast<uint16_t>(swapped ? width : height),
+                static_cast<uint16_t>(width),
+                static_cast<uint16_t>(height),
+                displayCommandType::blit,
+                op,
+                orientation};
+    return true;
+  }
+
+  /**
+   * @brief Adds a rectangle fill
+   *
+   * @param x       X position, can be negative
+   * @param y       Y position, can be negative
+   * @param width   rectangle width
+   * @param height  rectangle height
+   * @param op      operation to fill with, the rectangle acts as a source of set bits, OP_MOV sets, OP_NOT clears and
+   * OP_XOR inverts
+   * @return true   command added
+   * @return false  display list is full
+   */
+  bool fill(int x, int y, unsigned int width, unsigned int height, bitblitOperation op) {
+    displayCommand *command = add();
+    if (command == nullptr) return false;
+    *command = {nullptr,
+                nullptr,
+                static_cast<int16_t>(x),
+                static_cast<int16_t>(y),
+                static_cast<uint16_t>(width),
+                static_cast<uint16_t>(height),
+                static_cast<uint16_t>(width),
+                static_cast<uint16_t>(height),
+                displayCommandType::fill,
+                op,
+                bitblitOrientation::ORIENT_NORMAL};
+    return true;
+  }
+
+  /**
+   * @brief Adds a line of text, the string must stay valid until rendering is done
+   *
+   * @param x         X position, can be negative
+   * @param y         Y position, can be negative
+   * @param textFont  row oriented font to draw the text with
+   * @param string    zero terminated string
+   * @param op        operation to draw with
+   * @return true     command added
+   * @return false    display list is full
+   */
+  bool text(int x, int y, const font &textFont, const char *string, bitblitOperation op) {
+    displayCommand *command = add();
+    if (command == nullptr) return false;
+    *command = {string,
+                &textFont,
+                static_cast<int16_t>(x),
+                static_cast<int16_t>(y),
+                static_cast<uint16_t>(strlen(string) * textFont.xSize),
+                static_cast<uint16_t>(textFont.ySize),
+                static_cast<uint16_t>(textFont.xSize),
+                static_cast<uint16_t>(textFont.ySize),
+                displayCommandType::text,
+                op,
+                bitblitOrientation::ORIENT_NORMAL};
+    return true;
+  }
+
+  /**
+   * @brief Renders a single band of a row oriented display, all commands are inspected
+   *
+   * Bands can be rendered in any order, this is useful when rendering bands in parallel or directly into a framebuffer.
+   *
+   * @tparam destType   strip element type
+   * @param strip       strip buffer, is cleared before rendering
+   * @param stripStride elements between the start of two strip rows
+   * @param width       display width
+   * @param bandTop     display line that corresponds with the first strip row
+   * @param bandHeight  amount of lines in the band
+   */
+  template <typename destType>
+  void renderBand(destType *strip, unsigned int stripStride, unsigned int width, unsigned int bandTop,
+                  unsigned int bandHeight) const {
+    clearStrip(strip, stripStride, width, bandHeight);
+    for (size_t i = 0; i < count; i++) {
+      executeRows(commands[i], strip, stripStride, width, bandTop, bandHeight);
+    }
+  }
+
+  /**
+   * @brief Renders a single band of a page oriented display, all commands are inspected
+   *
+   * @param strip       strip buffer of bandPages pages of width bytes, is cleared before rendering
+   * @param width       display width
+   * @param bandTop     display line that corresponds with the first strip line, multiple of 8
+   * @param bandPages   amount of pages in the band
+   */
+  void renderBandPaged(uint8_t *strip, unsigned int width, unsigned int bandTop, unsigned int bandPages) const {
+    memset(strip, 0, width * bandPages);
+    for (size_t i = 0; i < count; i++) {
+      executePaged(commands[i], strip, width, bandTop, bandPages);
+    }
+  }
+
+  /**
+   * @brief Renders the complete row oriented display band by band
+   *
+   * Only commands that touch the current band are inspected. After every band the flush function is called, it should
+   * transfer the strip to the display and return the strip to render the next band into. By returning the other half of a
+   * double buffered strip, the flush function can start an asynchronous transfer while the next band is rendered, as long as
+   * it waits for the previous transfer to complete before starting a new one.
+   *
+   * @tparam destType       strip element type
+   * @tparam flushFunction  callable taking (unsigned int bandTop, unsigned int bandHeight) returning destType *
+   * @param strip           strip buffer of bandHeight rows for the first band
+   * @param stripStride     elements between the start of two strip rows
+   * @param width           display width
+   * @param height          display height
+   * @param bandHeight      amount of lines in a band
+   * @param flush           called after every band
+   */
+  template <typename destType, typename flushFunction>
+  void render(destType *strip, unsigned int stripStride, unsigned int width, unsigned int height, unsigned int bandHeight,
+              flushFunction &&flush) {
+    renderBands(height, bandHeight, [&](unsigned int bandTop, unsigned int lines) {
+      clearStrip(strip, stripStride, width, lines);
+      forEachActive(bandTop, lines,
+                    [&](const displayCommand &command) { executeRows(command, strip, stripStride, width, bandTop, lines); });
+      strip = flush(bandTop, lines);
+    });
+  }
+
+  /**
+   * @brief Renders the complete page oriented display band by band
+   *
+   * @tparam flushFunction  callable taking (unsigned int bandTop, unsigned int bandHeight) returning uint8_t *, see render
+   * @param strip           strip buffer of bandPages pages of width bytes for the first band
+   * @param width           display width
+   * @param height          display height, multiple of 8
+   * @param bandPages       amount of pages in a band
+   * @param flush           called after every band
+   */
+  template <typename flushFunction>
+  void renderPaged(uint8_t *strip, unsigned int width, unsigned int height, unsigned int bandPages, flushFunction &&flush) {
+    renderBands(height, bandPages * 8, [&](unsigned int bandTop, unsigned int lines) {
+      memset(strip, 0, width * bandPages);
+      forEachActive(bandTop, lines,
+                    [&](const displayCommand &command) { executePaged(command, strip, width, bandTop, lines / 8); });
+      strip = flush(bandTop, lines);
+    });
+  }
+
+ private:
+  displayCommand *add() {
+    if (count == N) return nullptr;
+    return &commands[count++];
+  }
+
+  static int top(const displayCommand &command) {
+    return command.y;
+  }
+
+  static int bottom(const displayCommand &command) {
+    return command.y + command.height;
+  }
+
+  template <typename destType>
+  static void clearStrip(destType *strip, unsigned int stripStride, unsigned int width, unsigned int lines) {
+    const destType zero = 0;
+    detail::fillRectClipped(strip, stripStride, width, lines, 0, 0, width, lines, &zero, 1, bitblitOperation::OP_MOV);
+  }
+
+  /**
+   * @brief Sorts commands on their top position and walks through the bands while keeping a set of active commands
+   *
+   * The active set is kept in the order the commands were added.
+   */
+  template <typename bandFunction>
+  void renderBands(unsigned int height, unsigned int bandHeight, bandFunction &&function) {
+    // stable insertion sort of command indices on top position
+    for (size_t i = 0; i < count; i++) {
+      size_t j = i;
+      while ((j > 0) && (top(commands[order[j - 1]]) > top(commands[i]))) {
+        order[j] = order[j - 1];
+        j--;
+      }
+      order[j] = static_cast<uint16_t>(i);
+    }
+    nextCommand = 0;
+    activeCount = 0;
+    for (unsigned int bandTop = 0; bandTop < height; bandTop += bandHeight) {
+      const unsigned int lines = (height - bandTop) < bandHeight ? height - bandTop : bandHeight;
+      // retire commands that ended above this band
+      size_t kept = 0;
+      for (size_t i = 0; i < activeCount; i++) {
+        if (bottom(commands[active[i]]) > static_cast<int>(bandTop)) active[kept++] = active[i];
+      }
+      activeCount = kept;
+      // admit commands that start in this band, keeping them in the order they were added
+      while ((nextCommand < count) && (top(commands[order[nextCommand]]) < static_cast<int>(bandTop + lines))) {
+        const uint16_t index = order[nextCommand++];
+        size_t j = activeCount++;
+        while ((j > 0) && (active[j - 1] > index)) {
+          active[j] = active[j - 1];
+          j--;
+        }
+        active[j] = index;
+      }
+      function(bandTop, lines);
+    }
+  }
+
+  template <typename commandFunction>
+  void forEachActive(unsigned int bandTop, unsigned int lines, commandFunction &&function) const {
+    for (size_t i = 0; i < activeCount; i++) {
+      const displayCommand &command = commands[active[i]];
+      if (top(command) < static_cast<int>(bandTop + lines)) function(command);
+    }
+  }
+
+  template <typename destType>
+  static void executeRows(const displayCommand &command, destType *strip, unsigned int stripStride, unsigned int width,
+                          unsigned int bandTop, unsigned int lines) {
+    const int y = command.y - static_cast<int>(bandTop);
+    if ((y >= static_cast<int>(lines)) || ((y + command.height) <= 0)) return;
+    switch (command.type) {
+      case displayCommandType::blit: {
+        const uint8_t *bitmap = static_cast<const uint8_t *>(command.data);
+        const unsigned int bitmapStride = ((command.srcWidth + 7u) / 8u) * 8u;
+        if (command.orientation == bitblitOrientation::ORIENT_NORMAL)
+          detail::bitblit2dClipped<false>(strip, stripStride, width, lines, command.x, y, bitmap, bitmapStride,
+                                          command.srcWidth, command.srcHeight, static_cast<const uint8_t *>(nullptr),
+                                          command.op);
+        else
+          detail::bitblit2dOrientedClipped(strip, stripStride, width, lines, command.x, y, bitmap, bitmapStride,
+                                           command.srcWidth, command.srcHeight, command.orientation, command.op);
+      } break;
+      case displayCommandType::fill: {
+        const destType ones = std::numeric_limits<destType>::max();
+        detail::fillRectClipped(strip, stripStride, width, lines, command.x, y, command.width, command.height, &ones, 1,
+                                command.op);
+      } break;
+      case displayCommandType::text: {
+        const font &textFont = *command.textFont;
+        const unsigned int glyphStride = ((textFont.xSize + 7u) / 8u) * 8u;
+        int x = command.x;
+        for (const char *c = static_cast<const char *>(command.data); *c != '\0'; c++) {
+          if (x >= static_cast<int>(width)) break;
+          if ((x + textFont.xSize) > 0)
+            detail::bitblit2dClipped<false>(strip, stripStride, width, lines, x, y, glyph(textFont, *c), glyphStride,
+                                            textFont.xSize, textFont.ySize, static_cast<const uint8_t *>(nullptr),
+                                            command.op);
+          x = x + textFont.xSize;
+        }
+      } break;
+    }
+  }
+
+  static void executePaged(const displayCommand &command, uint8_t *strip, unsigned int width, unsigned int bandTop,
+                           unsigned int pages) {
+    const unsigned int lines = pages * 8;
+    const int y = command.y - static_cast<int>(bandTop);
+    if ((y >= static_cast<int>(lines)) || ((y + command.height) <= 0)) return;
+    switch (command.type) {
+      case displayCommandType::blit:
+        bitblit2dpaged(strip, width, lines, command.x, y, static_cast<const uint8_t *>(command.data), command.srcWidth,
+                       command.srcHeight, command.orientation, command.op);
+        break;
+      case displayCommandType::fill: {
+        const uint8_t ones = 0xFF;
+        detail::fillRectPagedClipped(strip, width, lines, command.x, y, command.width, command.height, &ones, 1, command.op);
+      } break;
+      case displayCommandType::text: {
+        const font &textFont = *command.textFont;
+        int x = command.x;
+        for (const char *c = static_cast<const char *>(command.data); *c != '\0'; c++) {
+          if (x >= static_cast<int>(width)) break;
+          if ((x + textFont.xSize) > 0)
+            bitblit2dpaged(strip, width, lines, x, y, glyph(textFont, *c), textFont.xSize, textFont.ySize,
+                           bitblitOrientation::ORIENT_NORMAL, command.op);
+          x = x + textFont.xSize;
+        }
+      } break;
+    }
+  }
+
+  static const uint8_t *glyph(const font &textFont, char c) {
+    uint8_t index = static_cast<uint8_t>(c);
+    if (index >= (textFont.ascii2indexSize / sizeof(textFont.ascii2index[0]))) index = 0;
+    return ascii2Font(textFont, index);
+  }
+
+  size_t count;                       /**< amount of commands in the list */
+  size_t nextCommand;                 /**< next sorted command to admit while rendering */
+  size_t activeCount;                 /**< amount of commands touching the current band */
+  util::array<displayCommand, N> commands; /**< commands in the order they were added */
+  util::array<uint16_t, N> order;     /**< command indices sorted on top position */
+  util::array<uint16_t, N> active;    /**< command indices touching the current band, in the order they were added */
+};
+
+}  // namespace util
+
+#endif
@@ -0,0 +1,108 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file displaylist_parallel.hpp
+ *
+ * Band parallel rendering of display lists into full framebuffers on a thread pool, only for hosts
+ *
+ */
+#ifndef DISPLAYLIST_PARALLEL_HPP
+#define DISPLAYLIST_PARALLEL_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <displaylist.hpp>
+#include <sharp_memlcd.hpp>
+#include <threadpool.hpp>
+
+namespace util {
+
+/**
+ * @brief Renders a display list into a row oriented framebuffer, every band of lines is rendered as a separate job
+ *
+ * Bands cover disjoint framebuffer rows, so no locking is needed between the jobs.
+ *
+ * @tparam N          display list size
+ * @tparam destType   framebuffer element type
+ * @param pool        thread pool to render on
+ * @param list        display list to render
+ * @param dest        framebuffer
+ * @param destStride  elements between the start of two framebuffer rows
+ * @param width       display width
+ * @param height      display height
+ * @param bandHeight  amount of lines per job
+ */
+template <size_t N, typename destType>
+void renderParallel(threadPool &pool, const displayList<N> &list, destType *dest, unsigned int destStride, unsigned int width,
+                    unsigned int height, unsigned int bandHeight) {
+  const unsigned int bands = (height + bandHeight - 1) / bandHeight;
+  pool.parallelFor(0, bands, [&](unsigned int band) {
+    const unsigned int bandTop = band * bandHeight;
+    const unsigned int lines = (height - bandTop) < bandHeight ? height - bandTop : bandHeight;
+    list.renderBand(dest + bandTop * destStride, destStride, width, bandTop, lines);
+  });
+}
+
+/**
+ * @brief Renders a display list into a page oriented framebuffer, every band of pages is rendered as a separate job
+ *
+ * Bands are whole pages, so every framebuffer byte belongs to exactly one job.
+ *
+ * @tparam N          display list size
+ * @param pool        thread pool to render on
+ * @param list        display list to render
+ * @param dest        framebuffer
+ * @param width       display width
+ * @param height      display height, multiple of 8
+ * @param bandPages   amount of pages per job
+ */
+template <size_t N>
+void renderParallelPaged(threadPool &pool, const displayList<N> &list, uint8_t *dest, unsigned int width, unsigned int height,
+                         unsigned int bandPages) {
+  const unsigned int pages = height / 8;
+  const unsigned int bands = (pages + bandPages - 1) / bandPages;
+  pool.parallelFor(0, bands, [&](unsigned int band) {
+    const unsigned int bandPage = band * bandPages;
+    const unsigned int bandCount = (pages - bandPage) < bandPages ? pages - bandPage : bandPages;
+    list.renderBandPaged(dest + bandPage * width, width, bandPage * 8, bandCount);
+  });
+}
+
+/**
+ * @brief Renders a display list into the framebuffer of a sharp memory LCD, the out of band data is left untouched
+ *
+ * @tparam N          display list size
+ * @tparam config     LCD configuration
+ * @param pool        thread pool to render on
+ * @param list        display list to render
+ * @param lcd         LCD to render into
+ * @param bandLines   amount of lines per job
+ */
+template <size_t N, typename config>
+void renderParallel(threadPool &pool, const displayList<N> &list, sharpMemLcd<config> &lcd, unsigned int bandLines) {
+  renderParallel(pool, list, lcd.frameBuffer.data() + 1, (config::maxX / 16) + 1, config::maxX, config::maxY, bandLines);
+  lcd.updatePending = true;
+}
+
+/**
+ * @brief Renders a display list into the framebuffer of a page oriented display like SSD1306::display
+ *
+ * @tparam N            display list size
+ * @tparam displayType  display with a paged frameBuffer and maxX, maxY members
+ * @param pool          thread pool to render on
+ * @param list          display list to render
+ * @param display       display to render into
+ * @param bandPages     amount of pages per job
+ */
+template <size_t N, typename displayType>
+void renderParallelPaged(threadPool &pool, const displayList<N> &list, displayType &display, unsigned int bandPages) {
+  renderParallelPaged(pool, list, display.frameBuffer.data(), display.maxX, display.maxY, bandPages);
+}
+
+}  // namespace util
+
+#endif
@@ -16,12 +16,15 @@
 #include <cstddef>
 #include <cstdint>
 #include <array>
+#include <span>
+#include <transport.hpp>
 
 namespace util {
 namespace hardware_mocks {
 
 #include "hardware_mocks/spi_regs.hpp"
 #include "hardware_mocks/spi.hpp"
+#include "hardware_mocks/transport.hpp"
 
 }  // namespace hardware_mocks
 }  // namespace util
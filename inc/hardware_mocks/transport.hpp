@@ -0,0 +1,94 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file transport.hpp
+ *
+ * hardware mock transport class template, records the transactions of drivers using a transport
+ *
+ */
+#ifndef HARDWARE_MOCKS_TRANSPORT_HPP
+#define HARDWARE_MOCKS_TRANSPORT_HPP
+
+/**
+ * @brief Transport recording all transferred elements, transactions are stored one after another
+ *
+ * @tparam T              element type
+ * @tparam N              maximum amount of recorded elements
+ * @tparam maxTransactions maximum amount of recorded transactions
+ */
+template <typename T, size_t N, size_t maxTransactions = 16>
+class transportMock {
+ public:
+  using elementType = T; /**< element type of the transactions */
+
+  /**
+   * @brief clears the recorded transactions
+   *
+   */
+  void initialize(void) {
+    data.fill(0);
+    transactionEnds.fill(0);
+    dataCount = 0;
+    transactionCount = 0;
+    segmentCount = 0;
+    overflow = false;
+  }
+
+  /**
+   * @brief Records a transaction
+   *
+   * @param segments  segments of the transaction
+   * @return result   noError, streamFull when the transaction did not fit, the recording is then incomplete
+   */
+  result transfer(transferSegments<T> segments) {
+    if (transactionCount >= maxTransactions) {
+      overflow = true;
+      return streamFull;
+    }
+    for (const transferSegment<T> &segment : segments) {
+      segmentCount++;
+      for (const T &element : segment) {
+        if (dataCount >= N) {
+          overflow = true;
+          return streamFull;
+        }
+        data[dataCount++] = element;
+      }
+    }
+    transactionEnds[transactionCount++] = dataCount;
+    return noError;
+  }
+
+  /**
+   * @brief The mock completes every transaction immediately
+   *
+   * @return false  transaction is done
+   */
+  bool busy() const noexcept {
+    return false;
+  }
+
+  /**
+   * @brief Get the data of a transaction
+   *
+   * @param transaction         transaction number, starting at 0
+   * @return std::span<const T> elements of the transaction
+   */
+  std::span<const T> transaction(size_t transaction) const {
+    const size_t begin = transaction == 0 ? 0 : transactionEnds[transaction - 1];
+    return std::span<const T>(&data[begin], transactionEnds[transaction] - begin);
+  }
+
+  std::array<T, N> data{};                                /**< recorded elements of all transactions */
+  std::array<size_t, maxTransactions> transactionEnds{};  /**< end of every transaction in data */
+  size_t dataCount = 0;                                   /**< amount of recorded elements */
+  size_t transactionCount = 0;                            /**< amount of recorded transactions */
+  size_t segmentCount = 0;                                /**< amount of recorded segments */
+  bool overflow = false;                                  /**< a transaction did not fit */
+};
+
+#endif
@@ -0,0 +1,280 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file logqueue.hpp
+ *
+ * Multiple producer single consumer record queue, safe for producers in interrupts and the main loop at the same time
+ *
+ */
+#ifndef LOGQUEUE_HPP
+#define LOGQUEUE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array.hpp>
+#include <atomic.hpp>
+
+namespace util {
+
+/**
+ * @brief Record queue where producers reserve space, fill it and commit it without blocking each other
+ *
+ * Every record starts with a header word holding its length and a committed flag, records are padded to whole words.
+ * Space is reserved with a compare exchange on the head, a record that would wrap around the end of the buffer is
+ * preceded by a padding record so every record is contiguous. The consumer takes records in reservation order and stops
+ * at the first uncommitted one, so a producer that is interrupted between reserve and commit only delays the records
+ * after it.
+ *
+ * @tparam N buffer size in bytes, power of two
+ */
+template <size_t N>
+class mpscQueue {
+ public:
+  static_assert((N >= 8) && ((N & (N - 1)) == 0), "queue size must be a power of two of at least 8 bytes");
+  static_assert(N <= 65536, "queue size can be at most 65536 bytes");
+
+  /**
+   * @brief Space reserved for a record, valid when reserve succeeded
+   *
+   */
+  class reservation {
+   public:
+    /**
+     * @brief Payload of the record
+     *
+     * @return uint8_t* start of the reserved payload
+     */
+    uint8_t *data() const noexcept {
+      return payload;
+    }
+
+    /**
+     * @brief Size of the payload
+     *
+     * @return size_t payload size in bytes
+     */
+    size_t size() const noexcept {
+      return length;
+    }
+
+    /**
+     * @brief Checks if the reservation succeeded
+     *
+     * @return true space was reserved
+     */
+    explicit operator bool() const noexcept {
+      return header != nullptr;
+    }
+
+   private:
+    friend class mpscQueue;
+    uint32_t *header = nullptr; /**< header word of the record */
+    uint8_t *payload = nullptr; /**< payload of the record */
+    size_t length = 0;          /**< payload size */
+  };
+
+  /**
+   * @brief Reserves space for a record, can be called from any context
+   *
+   * @param bytes         payload size
+   * @return reservation  reserved space, not valid when the queue is full
+   */
+  reservation reserve(size_t bytes) noexcept {
+    reservation result;
+    const uint32_t recordSize = static_cast<uint32_t>(headerSize + ((bytes + headerSize - 1) & ~(headerSize - 1)));
+    if ((bytes > maxPayload) || (recordSize > N)) {
+      dropped.fetch_add(1, memory_order::relaxed);
+      return result;
+    }
+    uint32_t current = head.load(memory_order::relaxed);
+    uint32_t padding, next;
+    do {
+      const uint32_t offset = current % N;
+      padding = (offset + recordSize > N) ? static_cast<uint32_t>(N) - offset : 0;
+      next = current + padding + recordSize;
+      if (next - tail.load(memory_order::acquire) > N) {
+        dropped.fetch_add(1, memory_order::relaxed);
+        return result;
+      }
+    } while (!head.compare_exchange_weak(current, next, memory_order::acq_rel, memory_order::relaxed));
+    if (padding != 0) __atomic_store_n(word(current), committedFlag | paddingFlag | (padding - headerSize), __ATOMIC_RELEASE);
+    result.header = word(current + padding);
+    result.payload = reinterpret_cast<uint8_t *>(result.header + 1);
+    result.length = bytes;
+    return result;
+  }
+
+  /**
+   * @brief Makes a reserved record available to the consumer
+   *
+   * @param record reservation to commit
+   */
+  void commit(reservation &record) noexcept {
+    if (!record) return;
+    __atomic_store_n(record.header, committedFlag | static_cast<uint32_t>(record.length), __ATOMIC_RELEASE);
+    record.header = nullptr;
+  }
+
+  /**
+   * @brief Copies a record into the queue
+   *
+   * @param data    payload
+   * @param bytes   payload size
+   * @return true   record queued
+   * @return false  queue full, record dropped
+   */
+  bool push(const void *data, size_t bytes) noexcept {
+    reservation record = reserve(bytes);
+    if (!record) return false;
+    std::memcpy(record.data(), data, bytes);
+    commit(record);
+    return true;
+  }
+
+  /**
+   * @brief Passes the oldest record to a function without copying and removes it, only for the consumer
+   *
+   * @tparam recordFunction callable taking (const uint8_t *data, size_t bytes)
+   * @param function        called with the record
+   * @return true           a record was consumed
+   * @return false          no committed record available
+   */
+  template <typename recordFunction>
+  bool consume(recordFunction &&function) {
+    uint32_t current = tail.load(memory_order::relaxed);
+    while (true) {
+      if (current == head.load(memory_order::acquire)) return false;
+      uint32_t *header = word(current);
+      const uint32_t value = __atomic_load_n(header, __ATOMIC_ACQUIRE);
+      if ((value & committedFlag) == 0) return false;
+      const uint32_t length = value & lengthMask;
+      const uint32_t recordSize = static_cast<uint32_t>(headerSize + ((length + headerSize - 1) & ~(headerSize - 1)));
+      if ((value & paddingFlag) == 0) function(reinterpret_cast<const uint8_t *>(header + 1), static_cast<size_t>(length));
+      // clear the whole record, any of its words can become the header of a later record
+      for (uint32_t i = 0; i < recordSize; i += headerSize) __atomic_store_n(word(current + i), 0u, __ATOMIC_RELAXED);
+      current += recordSize;
+      tail.store(current, memory_order::release);
+      if ((value & paddingFlag) == 0) return true;
+    }
+  }
+
+  /**
+   * @brief Copies the oldest record out of the queue, only for the consumer
+   *
+   * @param dest      destination buffer
+   * @param maxBytes  destination size, longer records are truncated
+   * @return size_t   size of the record, 0 when no committed record is available
+   */
+  size_t pop(void *dest, size_t maxBytes) {
+    size_t recordBytes = 0;
+    consume([&](const uint8_t *data, size_t bytes) {
+      std::memcpy(dest, data, bytes < maxBytes ? bytes : maxBytes);
+      recordBytes = bytes;
+    });
+    return recordBytes;
+  }
+
+  /**
+   * @brief Checks if records are queued, committed or not
+   *
+   * @return true no records are queued
+   */
+  bool empty() const noexcept {
+    return head.load(memory_order::acquire) == tail.load(memory_order::acquire);
+  }
+
+  /**
+   * @brief Amount of records dropped because the queue was full
+   *
+   * @return uint32_t amount of dropped records
+   */
+  uint32_t droppedRecords() const noexcept {
+    return dropped.load(memory_order::relaxed);
+  }
+
+ private:
+  static constexpr size_t headerSize = sizeof(uint32_t);            /**< size of the record header */
+  static constexpr uint32_t committedFlag = 0x80000000u;            /**< record is complete */
+  static constexpr uint32_t paddingFlag = 0x40000000u;              /**< record fills the end of the buffer */
+  static constexpr uint32_t lengthMask = 0x0000FFFFu;               /**< payload size */
+  static constexpr size_t maxPayload = lengthMask;                  /**< largest payload */
+
+  uint32_t *word(uint32_t position) noexcept {
+    return &buffer[(position % N) / headerSize];
+  }
+
+  array<uint32_t, N / headerSize> buffer{}; /**< records */
+  atomic<uint32_t> head{0};                 /**< end of the reserved space, only increases */
+  atomic<uint32_t> tail{0};                 /**< start of the oldest record, only increases */
+  atomic<uint32_t> dropped{0};              /**< records dropped because the queue was full */
+};
+
+/**
+ * @brief Lanes of a log queue
+ *
+ */
+enum class logLane : uint8_t {
+  high, /*!< errors and other messages that must not be lost to a flood of bulk messages */
+  bulk, /*!< debug and trace messages */
+};
+
+/**
+ * @brief Log queue with separate lanes for high priority and bulk records, the consumer empties the high lane first
+ *
+ * Every lane has its own space, a full bulk lane never blocks high priority records.
+ *
+ * @tparam highSize size of the high priority lane in bytes, power of two
+ * @tparam bulkSize size of the bulk lane in bytes, power of two
+ */
+template <size_t highSize, size_t bulkSize>
+class logQueue {
+ public:
+  /**
+   * @brief Copies a record into a lane, can be called from any context
+   *
+   * @param lane    lane to queue in
+   * @param data    payload
+   * @param bytes   payload size
+   * @return true   record queued
+   * @return false  lane full, record dropped
+   */
+  bool push(logLane lane, const void *data, size_t bytes) noexcept {
+    return lane == logLane::high ? highLane.push(data, bytes) : bulkLane.push(data, bytes);
+  }
+
+  /**
+   * @brief Passes the oldest record of the highest lane that has one to a function and removes it
+   *
+   * @tparam recordFunction callable taking (logLane lane, const uint8_t *data, size_t bytes)
+   * @param function        called with the record
+   * @return true           a record was consumed
+   * @return false          no committed record available
+   */
+  template <typename recordFunction>
+  bool consume(recordFunction &&function) {
+    if (highLane.consume([&](const uint8_t *data, size_t bytes) { function(logLane::high, data, bytes); })) return true;
+    return bulkLane.consume([&](const uint8_t *data, size_t bytes) { function(logLane::bulk, data, bytes); });
+  }
+
+  /**
+   * @brief Amount of records dropped in a lane because it was full
+   *
+   * @param lane        lane to query
+   * @return uint32_t   amount of dropped records
+   */
+  uint32_t droppedRecords(logLane lane) const noexcept {
+    return lane == logLane::high ? highLane.droppedRecords() : bulkLane.droppedRecords();
+  }
+
+  mpscQueue<highSize> highLane; /**< high priority records, use directly for reserve and commit */
+  mpscQueue<bulkSize> bulkLane; /**< bulk records, use directly for reserve and commit */
+};
+
+}  // namespace util
+
+#endif
@@ -0,0 +1,180 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file pool.hpp
+ *
+ * Fixed block memory pool, constant time allocation without fragmentation
+ *
+ */
+#ifndef POOL_HPP
+#define POOL_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <array.hpp>
+#include <atomic.hpp>
+
+namespace util {
+
+/**
+ * @brief Usage statistics of a memory pool
+ *
+ */
+struct poolStatistics {
+  size_t used;       /*!< blocks currently allocated */
+  size_t highWater;  /*!< most blocks allocated at the same time */
+  size_t failures;   /*!< allocations that failed because the pool was empty */
+};
+
+/**
+ * @brief Pool of fixed size blocks with a lock free free list
+ *
+ * The free list is a stack of block indices, the head carries a tag that changes on every update to prevent the ABA
+ * problem. Allocation and deallocation are a compare exchange loop and can be used from interrupts and threads alike.
+ *
+ * @tparam blockSize  size of a block in bytes
+ * @tparam blockCount amount of blocks, less then 65535
+ * @tparam alignment  alignment of every block
+ */
+template <size_t blockSize, size_t blockCount, size_t alignment = alignof(std::max_align_t)>
+class blockPool {
+ public:
+  static_assert(blockCount > 0, "pool needs at least one block");
+  static_assert(blockCount < 0xFFFF, "pool can have at most 65534 blocks");
+
+  blockPool() noexcept {
+    for (size_t i = 0; i < blockCount; i++)
+      next[i].store(static_cast<uint16_t>(i + 1 < blockCount ? i + 1 : emptyIndex), memory_order::relaxed);
+    head.store(0, memory_order::release);
+  }
+
+  blockPool(const blockPool &) = delete;
+  blockPool &operator=(const blockPool &) = delete;
+
+  /**
+   * @brief Takes a block from the pool
+   *
+   * @return void* pointer to a block of blockSize bytes, nullptr when the pool is empty
+   */
+  void *allocate() noexcept {
+    uint32_t current = head.load(memory_order::acquire);
+    uint32_t desired;
+    do {
+      const uint16_t index = headIndex(current);
+      if (index == emptyIndex) {
+        failures.fetch_add(1, memory_order::relaxed);
+        return nullptr;
+      }
+      desired = makeHead(next[index].load(memory_order::relaxed), headTag(current) + 1);
+    } while (!head.compare_exchange_weak(current, desired, memory_order::acq_rel, memory_order::acquire));
+    updateHighWater(used.fetch_add(1, memory_order::relaxed) + 1);
+    return blocks[headIndex(current)].data;
+  }
+
+  /**
+   * @brief Returns a block to the pool
+   *
+   * @param block pointer returned by allocate, nullptr is ignored
+   */
+  void deallocate(void *block) noexcept {
+    if (block == nullptr) return;
+    const uint16_t index = static_cast<uint16_t>(static_cast<poolBlock *>(block) - blocks.data());
+    uint32_t current = head.load(memory_order::acquire);
+    do {
+      next[index].store(headIndex(current), memory_order::relaxed);
+    } while (!head.compare_exchange_weak(current, makeHead(index, headTag(current) + 1), memory_order::acq_rel,
+                                         memory_order::acquire));
+    used.fetch_sub(1, memory_order::relaxed);
+  }
+
+  /**
+   * @brief Checks if a pointer is a block of this pool
+   *
+   * @param block   pointer to check
+   * @return true   pointer is the start of one of the blocks
+   */
+  bool owns(const void *block) const noexcept {
+    const uint8_t *address = static_cast<const uint8_t *>(block);
+    const uint8_t *begin = blocks[0].data;
+    if ((address < begin) || (address >= begin + sizeof(poolBlock) * blockCount)) return false;
+    return ((address - begin) % sizeof(poolBlock)) == 0;
+  }
+
+  /**
+   * @brief Usage statistics of the pool
+   *
+   * @return poolStatistics usage statistics, the fields are sampled separately
+   */
+  poolStatistics statistics() const noexcept {
+    return poolStatistics{used.load(memory_order::relaxed), highWater.load(memory_order::relaxed),
+                          failures.load(memory_order::relaxed)};
+  }
+
+  /**
+   * @brief Resets the high water mark to the current usage and clears the failure count
+   *
+   */
+  void resetStatistics() noexcept {
+    highWater.store(used.load(memory_order::relaxed), memory_order::relaxed);
+    failures.store(0, memory_order::relaxed);
+  }
+
+  /**
+   * @brief Size of a block
+   *
+   * @return size_t size of a block in bytes
+   */
+  static constexpr size_t size() {
+    return blockSize;
+  }
+
+  /**
+   * @brief Amount of blocks in the pool
+   *
+   * @return size_t amount of blocks
+   */
+  static constexpr size_t capacity() {
+    return blockCount;
+  }
+
+ private:
+  static constexpr uint16_t emptyIndex = 0xFFFF; /**< index marking the end of the free list */
+
+  struct alignas(alignment) poolBlock {
+    uint8_t data[blockSize];
+  };
+
+  static constexpr uint16_t headIndex(uint32_t value) {
+    return static_cast<uint16_t>(value);
+  }
+
+  static constexpr uint32_t headTag(uint32_t value) {
+    return value >> 16;
+  }
+
+  static constexpr uint32_t makeHead(uint16_t index, uint32_t tag) {
+    return (tag << 16) | index;
+  }
+
+  void updateHighWater(size_t current) noexcept {
+    size_t previous = highWater.load(memory_order::relaxed);
+    while ((current > previous) &&
+           !highWater.compare_exchange_weak(previous, current, memory_order::relaxed, memory_order::relaxed)) {
+    }
+  }
+
+  array<poolBlock, blockCount> blocks;       /**< block storage */
+  array<atomic<uint16_t>, blockCount> next;  /**< free list link of every block */
+  atomic<uint32_t> head;                     /**< tag in the upper and first free block in the lower 16 bits */
+  atomic<size_t> used{0};                    /**< blocks currently allocated */
+  atomic<size_t> highWater{0};               /**< most blocks allocated at the same time */
+  atomic<size_t> failures{0};                /**< failed allocations */
+};
+
+}  // namespace util
+
+#endif
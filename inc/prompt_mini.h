@@ -41,6 +41,13 @@ typedef struct promptData {
 
 result promptProcess(promptData_t *const promptData, const datastreamChar_t *stream);
 
+/*
+Processes characters until the stream is empty or maxCharacters have been processed, for use after a notification.
+Returns noError when the limit was reached and characters can be left, otherwise the result of the read that stopped
+processing. Results of the command handler are not returned.
+*/
+result promptProcessBatch(promptData_t *const promptData, const datastreamChar_t *stream, unsigned int maxCharacters);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,60 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file queue_record.h
+ *
+ * Queue of variable length binary records
+ *
+ * Records are stored with a 16 bit length prefix, so they can contain any byte and are found without scanning. Every
+ * record is contiguous in the buffer, a record that does not fit before the end of the buffer starts at the beginning
+ * and the remainder is skipped. This allows peeking at the oldest record without copying it.
+ *
+ */
+#ifndef QUEUE_RECORD_H
+#define QUEUE_RECORD_H
+
+#include <results.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  queueRecordReject,    /**< enqueueing into a full queue fails */
+  queueRecordOverwrite, /**< enqueueing into a full queue removes the oldest records */
+} queueRecordPolicy_t;
+
+typedef struct queueRecord {
+  // size of data minus one, size must be power of two and at most 32768!
+  const uint16_t mask;
+  const queueRecordPolicy_t policy;
+  uint16_t head;
+  uint16_t tail;
+  uint16_t used;  // bytes in use, including length prefixes and skipped bytes
+  uint16_t count; // amount of records
+  uint8_t *data;
+} t_queueRecord;
+
+// empty the queue
+void queueRecordInit(t_queueRecord *__restrict__ queue);
+// add record of length bytes, when it does not fit the policy decides
+result queueRecordEnqueue(t_queueRecord *__restrict__ queue, const uint8_t *__restrict__ record, uint16_t length);
+// point record at the oldest record without removing it, valid until the record is removed or overwritten
+result queueRecordPeek(const t_queueRecord *__restrict__ queue, const uint8_t **__restrict__ record,
+                       uint16_t *__restrict__ length);
+// remove the oldest record
+result queueRecordSkip(t_queueRecord *__restrict__ queue);
+// copy the oldest record into record and remove it, fails without removing when size is too small
+result queueRecordDequeue(t_queueRecord *__restrict__ queue, uint8_t *__restrict__ record, uint16_t size,
+                          uint16_t *__restrict__ length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -39,6 +39,36 @@ class RingBuffer {
     return front == back;
   }
 
+  /**
+   * @brief Amount of elements in the ringbuffer
+   *
+   * @return size_t amount of elements
+   */
+  size_t size() const {
+    if (front >= back)
+      return static_cast<size_t>(front - back);
+    else
+      return static_cast<size_t>(N + 1) - static_cast<size_t>(back - front);
+  }
+
+  /**
+   * @brief Amount of elements that can still be added
+   *
+   * @return size_t amount of free elements
+   */
+  size_t free() const {
+    return N - size();
+  }
+
+  /**
+   * @brief Maximum amount of elements in the ringbuffer
+   *
+   * @return size_t capacity
+   */
+  constexpr size_t capacity() const {
+    return N;
+  }
+
   bool pushBack(const T& p) {
     if (full()) return false;
     auto temp = decrement(back);
@@ -0,0 +1,373 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file scheduler.hpp
+ *
+ * Cooperative scheduler for coroutines written with the sq_coro.hpp macros
+ *
+ */
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <array.hpp>
+#include <atomic.hpp>
+#include <sq_coro.hpp>
+
+#if !(defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M'))
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace util {
+
+#if defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M')
+/**
+ * @brief Idles the core with WFI until an interrupt occurs
+ *
+ * Interrupts are masked while checking if there is work, a pending interrupt still ends the WFI so no wake up is lost.
+ */
+struct cortexMIdle {
+  /**
+   * @brief Waits for an interrupt when there is no work
+   *
+   * @tparam predicate  callable returning true when there is nothing to do
+   * @param nothingToDo checked with interrupts masked
+   */
+  template <typename predicate>
+  void idle(predicate &&nothingToDo) noexcept {
+    __asm volatile("cpsid i" ::: "memory");
+    if (nothingToDo()) __asm volatile("wfi" ::: "memory");
+    __asm volatile("cpsie i" ::: "memory");
+  }
+
+  /**
+   * @brief Nothing needed, the interrupt itself ends the WFI
+   *
+   */
+  void notify() noexcept {}
+};
+
+using defaultIdle = cortexMIdle; /**< idle policy of this target */
+#else
+/**
+ * @brief Blocks the scheduler thread until another thread calls tick or signal
+ *
+ */
+struct hostIdle {
+  /**
+   * @brief Blocks while there is no work
+   *
+   * @tparam predicate  callable returning true when there is nothing to do
+   * @param nothingToDo checked with the lock held
+   */
+  template <typename predicate>
+  void idle(predicate &&nothingToDo) {
+    std::unique_lock<std::mutex> guard(lock);
+    wakeup.wait(guard, [&nothingToDo] { return !nothingToDo(); });
+  }
+
+  /**
+   * @brief Wakes the blocked scheduler thread
+   *
+   */
+  void notify() {
+    std::lock_guard<std::mutex> guard(lock);
+    wakeup.notify_all();
+  }
+
+  std::mutex lock;                  /**< protects the wait against missed notifications */
+  std::condition_variable wakeup;   /**< signals new ticks or events */
+};
+
+using defaultIdle = hostIdle; /**< idle policy of this target */
+#endif
+
+/**
+ * @brief Scheduling state of a task
+ *
+ */
+enum class taskState : uint8_t {
+  unused,    /*!< slot is free */
+  runnable,  /*!< task runs every scheduler round */
+  sleeping,  /*!< task waits until a tick count is reached */
+  waiting,   /*!< task waits for events */
+};
+
+/**
+ * @brief Task of the scheduler, passed to the task function on every run
+ *
+ * Task functions are coroutines on the coroutine state of the task:
+ *
+ *   void blink(util::task &self) {
+ *     CR_BEGIN(self.coroutine);
+ *     while (true) {
+ *       toggleLed();
+ *       CR_SLEEP(self, 500);
+ *     }
+ *     CR_END_V();
+ *   }
+ */
+class task {
+ public:
+  using taskFunction = void (*)(task &); /**< task function type */
+
+  /**
+   * @brief Lets the task sleep, use through CR_SLEEP
+   *
+   * @param ticks amount of ticks to sleep
+   */
+  void sleep(uint32_t ticks) noexcept {
+    wakeTime = ticks;
+    state = taskState::sleeping;
+  }
+
+  /**
+   * @brief Lets the task wait for events, use through CR_WAIT_EVENT
+   *
+   * @param mask events to wait for
+   */
+  void waitEvents(uint32_t mask) noexcept {
+    eventMask = mask;
+    received = 0;
+    state = taskState::waiting;
+  }
+
+  /**
+   * @brief Events that woke the task up
+   *
+   * @return uint32_t received events, a subset of the events waited for
+   */
+  uint32_t events() const noexcept {
+    return received;
+  }
+
+  /**
+   * @brief Removes the task from the scheduler, use through CR_EXIT
+   *
+   */
+  void exit() noexcept {
+    state = taskState::unused;
+  }
+
+  coroState coroutine;          /**< coroutine state of the task function */
+  void *context = nullptr;      /**< user data passed when adding the task */
+
+ private:
+  template <size_t, typename>
+  friend class scheduler;
+
+  taskFunction function = nullptr;       /**< task function */
+  taskState state = taskState::unused;   /**< scheduling state */
+  uint32_t wakeTime = 0;                 /**< sleep duration, converted to the wake up tick by the scheduler */
+  uint32_t eventMask = 0;                /**< events waited for */
+  uint32_t received = 0;                 /**< events that woke the task */
+};
+
+/**
+ * @brief Cooperative scheduler with a fixed table of tasks
+ *
+ * Sleeping and waiting tasks are not run until their time has come or their events are signalled, when no task is
+ * runnable the scheduler idles. tick and signal are safe to call from interrupts or, on hosts, other threads.
+ *
+ * Events are latched, an event signalled before a task waits for it wakes the task as soon as it waits. Every event is
+ * consumed by the tasks waiting for it in the round it is handled.
+ *
+ * @tparam N          maximum amount of tasks
+ * @tparam idlePolicy how to wait when no task is runnable, see cortexMIdle and hostIdle
+ */
+template <size_t N, typename idlePolicy = defaultIdle>
+class scheduler {
+ public:
+  /**
+   * @brief Adds a task to the scheduler
+   *
+   * @param function  task function
+   * @param context   user data, available to the task as context
+   * @return task*    added task, nullptr when the table is full
+   */
+  task *add(task::taskFunction function, void *context = nullptr) noexcept {
+    for (task &entry : tasks) {
+      if (entry.state != taskState::unused) continue;
+      entry.coroutine = coroState{};
+      entry.context = context;
+      entry.function = function;
+      entry.state = taskState::runnable;
+      return &entry;
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Advances the time, typically called from the systick interrupt
+   *
+   * @param ticks amount of ticks passed
+   */
+  void tick(uint32_t ticks = 1) noexcept {
+    now.fetch_add(ticks, memory_order::release);
+    idler.notify();
+  }
+
+  /**
+   * @brief Signals events to the waiting tasks
+   *
+   * @param eventBits events to signal
+   */
+  void signal(uint32_t eventBits) noexcept {
+    pendingEvents.fetch_or(eventBits, memory_order::release);
+    idler.notify();
+  }
+
+  /**
+   * @brief Current time
+   *
+   * @return uint32_t ticks since the start, wraps around
+   */
+  uint32_t time() const noexcept {
+    return now.load(memory_order::acquire);
+  }
+
+  /**
+   * @brief Wakes up tasks and runs every runnable task once
+   *
+   * @return true   at least one task was run
+   * @return false  no task was runnable
+   */
+  bool runOnce() {
+    wakeTasks();
+    bool ran = false;
+    for (task &entry : tasks) {
+      if (entry.state != taskState::runnable) continue;
+      entry.function(entry);
+      if (entry.state == taskState::sleeping) entry.wakeTime += time();
+      ran = true;
+    }
+    return ran;
+  }
+
+  /**
+   * @brief Runs the tasks forever, idling when no task is runnable
+   *
+   */
+  [[noreturn]] void run() {
+    while (true) {
+      if (!runOnce()) idler.idle([this] { return !workPending(); });
+    }
+  }
+
+  /**
+   * @brief Runs the tasks until no task is left, idling when no task is runnable
+   *
+   */
+  void runUntilDone() {
+    while (activeTasks() != 0) {
+      if (!runOnce()) idler.idle([this] { return !workPending(); });
+    }
+  }
+
+  /**
+   * @brief Amount of tasks in the scheduler
+   *
+   * @return size_t amount of tasks
+   */
+  size_t activeTasks() const noexcept {
+    size_t count = 0;
+    for (const task &entry : tasks) count += (entry.state != taskState::unused) ? 1 : 0;
+    return count;
+  }
+
+ private:
+  static bool reached(uint32_t current, uint32_t wakeTime) noexcept {
+    return static_cast<int32_t>(current - wakeTime) >= 0;
+  }
+
+  void wakeTasks() noexcept {
+    const uint32_t current = time();
+    const uint32_t events = pendingEvents.load(memory_order::acquire);
+    uint32_t consumed = 0;
+    for (task &entry : tasks) {
+      if ((entry.state == taskState::sleeping) && reached(current, entry.wakeTime)) {
+        entry.state = taskState::runnable;
+      } else if ((entry.state == taskState::waiting) && ((entry.eventMask & events) != 0)) {
+        entry.received = entry.eventMask & events;
+        consumed |= entry.received;
+        entry.state = taskState::runnable;
+      }
+    }
+    if (consumed != 0) pendingEvents.fetch_and(~consumed, memory_order::acq_rel);
+  }
+
+  bool workPending() const noexcept {
+    const uint32_t current = time();
+    const uint32_t events = pendingEvents.load(memory_order::acquire);
+    for (const task &entry : tasks) {
+      if (entry.state == taskState::runnable) return true;
+      if ((entry.state == taskState::sleeping) && reached(current, entry.wakeTime)) return true;
+      if ((entry.state == taskState::waiting) && ((entry.eventMask & events) != 0)) return true;
+    }
+    return false;
+  }
+
+  array<task, N> tasks;             /**< task table */
+  atomic<uint32_t> now{0};          /**< ticks since the start */
+  atomic<uint32_t> pendingEvents{0}; /**< signalled events not yet consumed */
+  idlePolicy idler;                 /**< waits when no task is runnable */
+};
+
+/**
+ * @brief Callback signalling scheduler events, for C style callbacks like the datastream notifier
+ *
+ * Example: dsNotifyInit(&uartNotifier, util::signalCallback<decltype(sched), uartEvent>, &sched);
+ *
+ * @tparam schedulerType  type of the scheduler
+ * @tparam eventBits      events to signal
+ * @param context         the scheduler
+ */
+template <typename schedulerType, uint32_t eventBits>
+void signalCallback(void *context) {
+  static_cast<schedulerType *>(context)->signal(eventBits);
+}
+
+}  // namespace util
+
+/**
+ * @brief Lets a scheduler task sleep, other tasks run in the meantime
+ *
+ * @param self  task passed to the task function
+ * @param ticks amount of ticks to sleep
+ */
+#define CR_SLEEP(self, ticks) \
+  do {                        \
+    (self).sleep(ticks);      \
+    CR_YIELD_V();             \
+  } while (0)
+
+/**
+ * @brief Lets a scheduler task wait for events, the received events are available through events()
+ *
+ * @param self    task passed to the task function
+ * @param mask    events to wait for
+ */
+#define CR_WAIT_EVENT(self, mask) \
+  do {                            \
+    (self).waitEvents(mask);      \
+    CR_YIELD_V();                 \
+  } while (0)
+
+/**
+ * @brief Ends a scheduler task, it is removed from the scheduler
+ *
+ * @param self  task passed to the task function
+ */
+#define CR_EXIT(self)  \
+  do {                 \
+    (self).exit();     \
+    CR_STOP_V(self);   \
+  } while (0)
+
+#endif
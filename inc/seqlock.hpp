@@ -0,0 +1,131 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file seqlock.hpp
+ *
+ * Sequence lock, consistent snapshots of multi word data without blocking the writer
+ *
+ */
+#ifndef SEQLOCK_HPP
+#define SEQLOCK_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <array.hpp>
+#include <atomic.hpp>
+
+namespace util {
+
+/**
+ * @brief Shares a value between a single writer and any amount of readers
+ *
+ * The writer never waits, readers retry when the value changed while they were copying it. The sequence counter is odd
+ * while a write is in progress. The value is stored as words accessed with relaxed atomics, so a torn copy is detected
+ * and discarded instead of being undefined behaviour. Typical use is an interrupt writing sensor data and the main loop
+ * reading it:
+ *
+ *   util::seqlock<reading> latest;
+ *   void ADC_IRQHandler() { latest.write(reading{...}); }
+ *   reading current = latest.read();
+ *
+ * Multiple writers must serialize their writes themselves.
+ *
+ * @tparam T trivially copyable value type
+ */
+template <typename T>
+class seqlock {
+ public:
+  static_assert(std::is_trivially_copyable_v<T>, "seqlock values are copied bytewise");
+
+  seqlock() noexcept : seqlock(T{}) {}
+
+  /**
+   * @brief Creates a seqlock holding an initial value
+   *
+   * @param value initial value
+   */
+  explicit seqlock(const T &value) noexcept {
+    storeWords(value);
+  }
+
+  seqlock(const seqlock &) = delete;
+  seqlock &operator=(const seqlock &) = delete;
+
+  /**
+   * @brief Replaces the value, only one writer at a time
+   *
+   * @param value new value
+   */
+  void write(const T &value) noexcept {
+    const unsigned int current = sequence.load(memory_order::relaxed);
+    sequence.store(current + 1, memory_order::relaxed);
+    atomic_thread_fence(memory_order::release);
+    storeWords(value);
+    sequence.store(current + 2, memory_order::release);
+  }
+
+  /**
+   * @brief Takes a single attempt to read a consistent value
+   *
+   * @param value   destination, only valid when true is returned
+   * @return true   value is consistent
+   * @return false  a write was in progress, try again
+   */
+  bool tryRead(T &value) const noexcept {
+    const unsigned int before = sequence.load(memory_order::acquire);
+    if ((before & 1) != 0) return false;
+    loadWords(value);
+    atomic_thread_fence(memory_order::acquire);
+    return sequence.load(memory_order::relaxed) == before;
+  }
+
+  /**
+   * @brief Reads a consistent value, retrying while writes interfere
+   *
+   * Do not call from a context with a higher priority then the writer, the writer can not finish while it is preempted.
+   *
+   * @return T consistent copy of the value
+   */
+  T read() const noexcept {
+    T value;
+    while (!tryRead(value)) {
+    }
+    return value;
+  }
+
+  /**
+   * @brief Amount of writes so far, can be used to check for new values without reading
+   *
+   * @return unsigned int amount of completed writes
+   */
+  unsigned int version() const noexcept {
+    return sequence.load(memory_order::acquire) / 2;
+  }
+
+ private:
+  static constexpr size_t wordCount = (sizeof(T) + sizeof(unsigned int) - 1) / sizeof(unsigned int);
+
+  void storeWords(const T &value) noexcept {
+    array<unsigned int, wordCount> words{};
+    std::memcpy(words.data(), &value, sizeof(T));
+    for (size_t i = 0; i < wordCount; i++) __atomic_store_n(&data[i], words[i], __ATOMIC_RELAXED);
+  }
+
+  void loadWords(T &value) const noexcept {
+    array<unsigned int, wordCount> words;
+    for (size_t i = 0; i < wordCount; i++) words[i] = __atomic_load_n(&data[i], __ATOMIC_RELAXED);
+    std::memcpy(&value, words.data(), sizeof(T));
+  }
+
+  atomic<unsigned int> sequence{0};     /**< write counter, odd while a write is in progress */
+  array<unsigned int, wordCount> data;  /**< value stored as words */
+};
+
+}  // namespace util
+
+#endif
@@ -18,6 +18,9 @@
 #include <string.h>
 #include <array.hpp>
 #include <bitblit.hpp>
+#include <bit/fill.hpp>
+#include <displaylist.hpp>
+#include <transport.hpp>
 
 namespace util {
 template <int xSize, int ySize, int shift>
@@ -43,6 +46,8 @@ struct sharpMemLcd {
     static_assert(config::maxY > 0, "display cant have zero Y");
     // TODO static asserts if display X is not multiple of 16
     // clear the buffer, it also sets up the sharp additional bits
+    vcom = 0x0000;
+    vcomOwed = false;
     setBuffer(0x0000);
   }
 
@@ -60,6 +65,7 @@ struct sharpMemLcd {
       frameBuffer[index] = frameBuffer[index] & ~(0x01 << (x & 0xF));
     else
       frameBuffer[index] = frameBuffer[index] | (0x01 << (x & 0xF));
+    updatePending = true;
   }
 
   uint8_t getPixel(const uint8_t *block, uint16_t blockWidth, uint16_t x, uint16_t y) {
@@ -68,19 +74,72 @@ struct sharpMemLcd {
     return (block[index] & mask);
   }
 
-  void lcdUpdate(auto xferFunction) {
+  void lcdUpdate(auto xferFunction)
+    requires(!transport<decltype(xferFunction), uint16_t>)
+  {
     // TODO write only dirty lines to LCD
+    // only the mode byte of the first line is interpreted as mode, it carries the current vcom state
+    frameBuffer[0] = static_cast<uint16_t>((frameBuffer[0] & ~vcomBit) | vcom);
+    updatePending = false;
+    vcomOwed = false;
     xferFunction(frameBuffer.begin(), frameBuffer.end());
   }
 
-  void flipVcom(auto xferFunction) {
-    // update all vcoms in all bits
-    // TODO, change this when doing LCD update with dirty lines
-    for (uint16_t i = 0; i < config::maxY; i++) {
-      frameBuffer[computeLineAddres(i)] = frameBuffer[computeLineAddres(i)] ^ 0x0002;
-    }
-    // the first word of the framebuffer contains always a vcom signal
-    xferFunction(frameBuffer.begin(), frameBuffer.begin() + 1);
+  /**
+   * @brief Inverts VCOM, call periodically to prevent a DC bias on the LCD
+   *
+   * When an update is pending the inversion is owed and sent along with the next lcdUpdate, otherwise only the 2 byte
+   * VCOM command is transferred. When the owed inversion did not go out before the next flip, it is sent as VCOM command
+   * first, so the LCD is never more then one inversion behind.
+   *
+   * @param xferFunction transfer function, gets begin and end of the words to transfer
+   */
+  void flipVcom(auto xferFunction)
+    requires(!transport<decltype(xferFunction), uint16_t>)
+  {
+    // an owed inversion means the update is still pending, so this sends at most one command
+    if (vcomOwed) sendVcom(xferFunction);
+    vcom = vcom ^ vcomBit;
+    if (updatePending)
+      vcomOwed = true;
+    else
+      sendVcom(xferFunction);
+  }
+
+  void sendVcom(auto xferFunction) {
+    // mode byte with only VCOM followed by the trailing dummy byte
+    vcomCommand = vcom;
+    xferFunction(&vcomCommand, &vcomCommand + 1);
+  }
+
+  /**
+   * @brief Sends the framebuffer over a transport, the framebuffer must not be changed while the transport is busy
+   *
+   * @tparam transportType  transport of uint16_t elements, see transport.hpp
+   * @param bus             transport to the LCD
+   */
+  template <typename transportType>
+    requires transport<transportType, uint16_t>
+  void lcdUpdate(transportType &bus) {
+    lcdUpdate([&bus](const uint16_t *begin, const uint16_t *end) {
+      const transferSegment<uint16_t> segments[] = {{begin, end}};
+      bus.transfer(segments);
+    });
+  }
+
+  /**
+   * @brief Inverts VCOM over a transport, see flipVcom
+   *
+   * @tparam transportType  transport of uint16_t elements, see transport.hpp
+   * @param bus             transport to the LCD
+   */
+  template <typename transportType>
+    requires transport<transportType, uint16_t>
+  void flipVcom(transportType &bus) {
+    flipVcom([&bus](const uint16_t *begin, const uint16_t *end) {
+      const transferSegment<uint16_t> segments[] = {{begin, end}};
+      bus.transfer(segments);
+    });
   }
 
   void setBuffer(uint16_t value) {
@@ -91,20 +150,154 @@ struct sharpMemLcd {
       // add M0, M1, M2 bits and line addres to beginning of each line entry
       frameBuffer[computeLineAddres(i)] = 0x01 | (i + 1) << config::addrShift;
     }
+    updatePending = true;
   }
 
   // xPos, yPos, blockWidth, blockHeight are in bits!
   void bitBlockTransfer(unsigned int xPos, unsigned int yPos, const uint8_t *block, unsigned int blockWidth,
                         unsigned int blockHeight, bitblitOperation op) {
-    // the framebuffer contains some out of band data, fix this
-    bitblit2dsmall(frameBuffer.data(), maxX + 16, maxY, xPos + 16, yPos, block, blockWidth, blockHeight, op);
+    const unsigned int blockStride = ((blockWidth + 7) / 8) * 8;
+    bitBlockTransfer(xPos, yPos, block, blockStride, 0, 0, blockWidth, blockHeight, op);
+  }
+
+  // xPos, yPos, blockX, blockY, blockWidth, blockHeight are in bits! transfers a block out of a larger bitmap like a sprite
+  // sheet, blockStride is the amount of bits between the start of two bitmap rows
+  void bitBlockTransfer(unsigned int xPos, unsigned int yPos, const uint8_t *block, unsigned int blockStride, unsigned int blockX,
+                        unsigned int blockY, unsigned int blockWidth, unsigned int blockHeight, bitblitOperation op) {
+    // skip the out of band data at the start of the first line, stride takes care of the other lines
+    bitblit2dsmall(frameBuffer.data() + 1, (maxX / 16) + 1, maxX, maxY, xPos, yPos, block, blockStride, blockX, blockY,
+                   blockWidth, blockHeight, op);
     // TODO: make lines dirty that have been touched
+    updatePending = true;
+  }
+
+  // xPos, yPos, blockWidth, blockHeight are in bits! positions can be negative, the sprite is clipped to the display
+  void spriteBlockTransfer(int xPos, int yPos, const uint8_t *block, const uint8_t *mask, unsigned int blockWidth,
+                           unsigned int blockHeight, bitblitOperation op) {
+    // skip the out of band data at the start of the first line, stride takes care of the other lines
+    const unsigned int blockStride = ((blockWidth + 7) / 8) * 8;
+    detail::bitblit2dClipped<true>(frameBuffer.data() + 1, (maxX / 16) + 1, maxX, maxY, xPos, yPos, block, blockStride,
+                                   blockWidth, blockHeight, mask, op);
+    updatePending = true;
+  }
+
+  // xPos, yPos, blockWidth, blockHeight are in bits! block is rotated or mirrored while transferring
+  void orientedBlockTransfer(int xPos, int yPos, const uint8_t *block, unsigned int blockWidth, unsigned int blockHeight,
+                             bitblitOrientation orientation, bitblitOperation op) {
+    const unsigned int blockStride = ((blockWidth + 7) / 8) * 8;
+    detail::bitblit2dOrientedClipped(frameBuffer.data() + 1, (maxX / 16) + 1, maxX, maxY, xPos, yPos, block, blockStride,
+                                     blockWidth, blockHeight, orientation, op);
+    updatePending = true;
+  }
+
+  // x, y, width, height are in bits! positions can be negative, the rectangle is clipped to the display
+  void fillRect(int x, int y, unsigned int width, unsigned int height, bool set) {
+    const uint16_t value = set ? 0xFFFF : 0x0000;
+    detail::fillRectClipped(frameBuffer.data() + 1, (maxX / 16) + 1, maxX, maxY, x, y, width, height, &value, 1,
+                            bitblitOperation::OP_MOV);
+    updatePending = true;
+  }
+
+  void invertRect(int x, int y, unsigned int width, unsigned int height) {
+    const uint16_t value = 0xFFFF;
+    detail::fillRectClipped(frameBuffer.data() + 1, (maxX / 16) + 1, maxX, maxY, x, y, width, height, &value, 1,
+                            bitblitOperation::OP_XOR);
+    updatePending = true;
+  }
+
+  // pattern contains one 16 bit word per pattern row, repeated horizontally
+  void patternFill(int x, int y, unsigned int width, unsigned int height, const uint16_t *pattern, unsigned int patternHeight,
+                   bitblitOperation op) {
+    detail::fillRectClipped(frameBuffer.data() + 1, (maxX / 16) + 1, maxX, maxY, x, y, width, height, pattern, patternHeight,
+                            op);
+    updatePending = true;
   }
 
   // Adding 16 bit word per row for spi data setup and teardown
   array<uint16_t, ((config::maxX / 16) + 1) * config::maxY> frameBuffer;
   static const uint16_t maxX = config::maxX;
   static const uint16_t maxY = config::maxY;
+  static const uint16_t vcomBit = 0x0002;  // M1 bit of the mode byte
+  uint16_t vcom = 0x0000;                  // current VCOM state, 0 or vcomBit
+  uint16_t vcomCommand = 0x0000;           // VCOM only command, kept here as transfers can outlive flipVcom
+  bool updatePending = true;               // framebuffer changed since lcdUpdate, set when writing frameBuffer directly
+  bool vcomOwed = false;                   // last inversion waits for lcdUpdate and was not sent to the LCD yet
+};
+
+/**
+ * @brief Sharp memory LCD driver without a framebuffer, renders a display list through two small strip buffers
+ *
+ * Each strip holds bandLines display lines including the out of band data per line. While one strip is being transferred
+ * the next band is rendered into the other strip, the transfer function must wait for the previous transfer to be finished
+ * before starting a new one.
+ *
+ * @tparam config     LCD configuration
+ * @tparam bandLines  amount of lines per strip
+ */
+template <typename config, int bandLines>
+struct sharpMemLcdBanded {
+  static_assert(bandLines > 0, "band cant have zero lines");
+
+  void init(void) {
+    static_assert(config::maxX > 0, "display cant have zero X");
+    static_assert(config::maxY > 0, "display cant have zero Y");
+    current = 0;
+    vcom = 0x0000;
+    vcomOwed = false;
+    updatePending = true;
+  }
+
+  template <size_t N>
+  void lcdUpdate(displayList<N> &list, auto xferFunction) {
+    updatePending = false;
+    vcomOwed = false;
+    list.render(strips[current].data() + 1, stride, maxX, maxY, bandLines, [&](unsigned int bandTop, unsigned int lines) {
+      uint16_t *strip = strips[current].data();
+      for (unsigned int i = 0; i < lines; i++) {
+        // add M0, M1, M2 bits and line addres to beginning of each line entry, every band starts with a mode byte so
+        // each header carries the current vcom state, for the other lines it is a dummy byte
+        strip[i * stride] = static_cast<uint16_t>(0x01 | vcom | (bandTop + i + 1) << config::addrShift);
+      }
+      xferFunction(strips[current].begin(), strips[current].begin() + lines * stride);
+      current = current ^ 1;
+      return strips[current].data() + 1;
+    });
+  }
+
+  /**
+   * @brief Inverts VCOM, call periodically to prevent a DC bias on the LCD
+   *
+   * Works like sharpMemLcd::flipVcom, when an update is pending the inversion is owed to the next lcdUpdate. Set
+   * updatePending when the display list changed.
+   *
+   * @param xferFunction transfer function, gets begin and end of the words to transfer
+   */
+  void flipVcom(auto xferFunction) {
+    // an owed inversion means the update is still pending, so this sends at most one command
+    if (vcomOwed) sendVcom(xferFunction);
+    vcom = vcom ^ vcomBit;
+    if (updatePending)
+      vcomOwed = true;
+    else
+      sendVcom(xferFunction);
+  }
+
+  void sendVcom(auto xferFunction) {
+    // mode byte with only VCOM followed by the trailing dummy byte
+    vcomCommand = vcom;
+    xferFunction(&vcomCommand, &vcomCommand + 1);
+  }
+
+  static const uint16_t maxX = config::maxX;
+  static const uint16_t maxY = config::maxY;
+  static const unsigned int stride = (config::maxX / 16) + 1;
+  static const uint16_t vcomBit = 0x0002;  // M1 bit of the mode byte
+  array<uint16_t, stride * bandLines> strips[2];
+  unsigned int current;
+  uint16_t vcom = 0x0000;         // current VCOM state, 0 or vcomBit
+  uint16_t vcomCommand = 0x0000;  // VCOM only command, kept here as transfers can outlive flipVcom
+  bool updatePending = true;      // display list changed since lcdUpdate, set by the application
+  bool vcomOwed = false;          // last inversion waits for lcdUpdate and was not sent to the LCD yet
 };
 
 };  // namespace util
@@ -12,20 +12,123 @@
  *
  * https://gcc.gnu.org/onlinedocs/gcc/Labels-as-Values.html
  *
+ * Coroutines started with CR_BEGIN keep their state in a function local static, so only one instance of such a
+ * coroutine function can exist. Coroutines started with CR_BEGIN_CTX keep their state in a crContext_t passed by the
+ * caller, every context is an independent instance. The other macros work with both.
+ *
+ * When NDEBUG is not defined every context carries guard words and the function owning it, CR_BEGIN_CTX checks them
+ * and calls CR_CORRUPT_HANDLER when a context was overwritten, not initialized or passed to another coroutine function.
+ * Release builds store only the label.
+ *
  */
 #ifndef COROUTINE_H
 #define COROUTINE_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include "sq_coro_common.h"
 
+#ifndef NDEBUG
+#define CR_CONTEXT_GUARD 0xC0C0A5A5u /**< guard word value of initialized contexts */
+
+#ifndef CR_CORRUPT_HANDLER
+/**
+ * @brief Called with the context when a corrupted context is detected, can be overridden before including this header
+ */
+#define CR_CORRUPT_HANDLER(context) __builtin_trap()
+#endif
+#endif
+
+/**
+ * @brief State of a coroutine instance started with CR_BEGIN_CTX
+ *
+ */
+typedef struct crContext {
+#ifndef NDEBUG
+  uint32_t guardHead; /**< overwritten when the memory before the label overflows */
+  const char* owner;  /**< coroutine function this context belongs to, NULL until the first run */
+#endif
+  void* label; /**< resume point, NULL before the first run */
+#ifndef NDEBUG
+  uint32_t guardTail; /**< overwritten when the memory after the label overflows */
+#endif
+} crContext_t;
+
+#ifndef NDEBUG
+/**
+ * @brief Initializer of a coroutine context, use for every context before its first run
+ *
+ */
+#define CR_CONTEXT_INIT \
+  { CR_CONTEXT_GUARD, NULL, NULL, CR_CONTEXT_GUARD }
+
+/**
+ * @brief Checks the guard words and owner of a context
+ *
+ * @param context coroutine context to check
+ */
+#define CR_CONTEXT_CHECK(context)                                                                 \
+  do {                                                                                            \
+    if (((context)->guardHead != CR_CONTEXT_GUARD) || ((context)->guardTail != CR_CONTEXT_GUARD)) \
+      CR_CORRUPT_HANDLER(context);                                                                \
+    if ((context)->owner == NULL)                                                                 \
+      (context)->owner = __func__;                                                                \
+    else if ((context)->owner != __func__)                                                        \
+      CR_CORRUPT_HANDLER(context);                                                                \
+  } while (0)
+#else
+#define CR_CONTEXT_INIT \
+  { NULL }
+#define CR_CONTEXT_CHECK(context) \
+  do {                            \
+  } while (0)
+#endif
+
+/**
+ * @brief Resets a coroutine context so its next run starts at the beginning
+ *
+ * @param context coroutine context to reset
+ */
+#define CR_CONTEXT_RESET(context)              \
+  do {                                         \
+    *(context) = (crContext_t)CR_CONTEXT_INIT; \
+  } while (0)
+
+/**
+ * @brief Stores a resume point, labels are function local so GCC warns about dangling pointers
+ *
+ * @param label label to resume at
+ */
+#define CR_SET_LABEL(label)                                   \
+  do {                                                        \
+    _Pragma("GCC diagnostic push");                           \
+    _Pragma("GCC diagnostic ignored \"-Wdangling-pointer\""); \
+    *crCurrent = &&label;                                     \
+    _Pragma("GCC diagnostic pop");                            \
+  } while (0)
+
+/**
+ * @brief Start of coroutine with a single instance
+ *
+ */
+#define CR_BEGIN                       \
+  do {                                 \
+    static void* crState = &&CR_START; \
+    void** const crCurrent = &crState; \
+    goto** crCurrent;                  \
+  CR_START:;
+
 /**
- * @brief Start of coroutine
+ * @brief Start of coroutine with its state in a context, one context per instance
  *
+ * @param context pointer to the crContext_t of the instance
  */
-#define CR_BEGIN                         \
-  do {                                   \
-    static void* crCurrent = &&CR_START; \
-    goto* crCurrent;                     \
+#define CR_BEGIN_CTX(context)                       \
+  do {                                              \
+    CR_CONTEXT_CHECK(context);                      \
+    void** const crCurrent = &(context)->label;     \
+    if (*crCurrent == NULL) CR_SET_LABEL(CR_START); \
+    goto** crCurrent;                               \
   CR_START:;
 
 /**
@@ -35,7 +138,7 @@
  *
  */
 #define CR_END(retval)    \
-  crCurrent = &&CR_START; \
+  CR_SET_LABEL(CR_START); \
   return retval;          \
   }                       \
   while (0)
@@ -45,7 +148,7 @@
  *
  */
 #define CR_END_V          \
-  crCurrent = &&CR_START; \
+  CR_SET_LABEL(CR_START); \
   return;                 \
   }                       \
   while (0)
@@ -58,7 +161,7 @@
  */
 #define CR_YIELD(retval)    \
   do {                      \
-    crCurrent = &&CR_LABEL; \
+    CR_SET_LABEL(CR_LABEL); \
     return (retval);        \
   CR_LABEL:;                \
   } while (0)
@@ -69,7 +172,7 @@
  */
 #define CR_YIELD_V          \
   do {                      \
-    crCurrent = &&CR_LABEL; \
+    CR_SET_LABEL(CR_LABEL); \
     return;                 \
   CR_LABEL:;                \
   } while (0)
@@ -83,7 +186,7 @@
  */
 #define CR_WAIT(retval, cond) \
   do {                        \
-    crCurrent = &&CR_LABEL;   \
+    CR_SET_LABEL(CR_LABEL);   \
   CR_LABEL:;                  \
     if (!(cond))              \
       return retval;          \
@@ -97,7 +200,7 @@
  */
 #define CR_WAIT_V(cond)     \
   do {                      \
-    crCurrent = &&CR_LABEL; \
+    CR_SET_LABEL(CR_LABEL); \
   CR_LABEL:;                \
     if (!(cond))            \
       return;               \
@@ -134,7 +237,7 @@
  */
 #define CR_STOP(retval)     \
   do {                      \
-    crCurrent = &&CR_START; \
+    CR_SET_LABEL(CR_START); \
     return (retval);        \
   } while (0)
 
@@ -144,7 +247,7 @@
  */
 #define CR_STOP_V           \
   do {                      \
-    crCurrent = &&CR_START; \
+    CR_SET_LABEL(CR_START); \
     return;                 \
   } while (0)
 
@@ -0,0 +1,240 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file static_string.hpp
+ *
+ * String with a fixed capacity, storage is part of the object so no heap is used
+ *
+ */
+#ifndef STATIC_STRING_HPP
+#define STATIC_STRING_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <format.hpp>
+
+namespace util {
+
+/**
+ * @brief NUL terminated string with a fixed capacity
+ *
+ * Appending truncates at the capacity. Numbers are appended with the format.hpp functions working directly on the free
+ * part of the storage, strings are appended with a single length check.
+ *
+ * @tparam N  capacity in characters, excluding the terminating NUL
+ */
+template <size_t N>
+class static_string {
+ public:
+  static_string() noexcept {
+    storage[0] = '\0';
+  }
+
+  /**
+   * @brief Creates a string from a string view, truncated at the capacity
+   *
+   * @param string initial contents
+   */
+  static_string(std::string_view string) noexcept {
+    storage[0] = '\0';
+    append(string);
+  }
+
+  /**
+   * @brief Appends a string, truncated at the capacity
+   *
+   * @param string          string to append
+   * @return static_string& this string
+   */
+  static_string &append(std::string_view string) noexcept {
+    const size_t amount = string.size() < (N - length) ? string.size() : N - length;
+    std::memcpy(&storage[length], string.data(), amount);
+    length += amount;
+    storage[length] = '\0';
+    return *this;
+  }
+
+  /**
+   * @brief Appends a character, ignored when the string is full
+   *
+   * @param c               character to append
+   * @return static_string& this string
+   */
+  static_string &append(char c) noexcept {
+    if (length < N) {
+      storage[length++] = c;
+      storage[length] = '\0';
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Appends using an append function from format.hpp or a function with the same signature
+   *
+   * Example: string.appendWith([](std::span<char> s) { return util::appendHex(s, value); });
+   *
+   * @tparam appendFunction callable taking and returning std::span<char> like the format.hpp functions
+   * @param function        append function, gets the free part of the storage including room for the NUL
+   * @return static_string& this string
+   */
+  template <typename appendFunction>
+  static_string &appendWith(appendFunction &&function) {
+    std::span<char> remaining = function(free());
+    length = static_cast<size_t>(remaining.data() - storage);
+    return *this;
+  }
+
+  /**
+   * @brief Appends a number in decimal, truncated at the capacity
+   *
+   * @tparam T              integer type supported by util::appendDec
+   * @param value           number to append
+   * @return static_string& this string
+   */
+  template <typename T>
+  static_string &appendDec(T value) {
+    return appendWith([value](std::span<char> buffer) { return util::appendDec(buffer, value); });
+  }
+
+  /**
+   * @brief Appends a number in hex, truncated at the capacity
+   *
+   * @tparam T              unsigned integer type supported by util::appendHex
+   * @param value           number to append
+   * @return static_string& this string
+   */
+  template <typename T>
+  static_string &appendHex(T value) {
+    return appendWith([value](std::span<char> buffer) { return util::appendHex(buffer, value); });
+  }
+
+  /**
+   * @brief Appends a string
+   *
+   * @param string          string to append
+   * @return static_string& this string
+   */
+  static_string &operator+=(std::string_view string) noexcept {
+    return append(string);
+  }
+
+  /**
+   * @brief Appends a character
+   *
+   * @param c               character to append
+   * @return static_string& this string
+   */
+  static_string &operator+=(char c) noexcept {
+    return append(c);
+  }
+
+  /**
+   * @brief Makes the string empty
+   *
+   */
+  void clear() noexcept {
+    length = 0;
+    storage[0] = '\0';
+  }
+
+  /** \brief Return amount of characters
+  \return amount of characters, excluding the terminating NUL
+  */
+  constexpr size_t size() const noexcept {
+    return length;
+  }
+
+  /** \brief Return the capacity
+  \return maximum amount of characters
+  */
+  static constexpr size_t capacity() noexcept {
+    return N;
+  }
+
+  /** \brief Return if the string is empty
+  \return true if the string is empty
+  */
+  constexpr bool empty() const noexcept {
+    return length == 0;
+  }
+
+  /** \brief Return if the string is full
+  \return true if no characters can be added
+  */
+  constexpr bool full() const noexcept {
+    return length == N;
+  }
+
+  /** \brief Return the NUL terminated string
+  \return pointer to the NUL terminated string
+  */
+  const char *c_str() const noexcept {
+    return storage;
+  }
+
+  /** \brief Return a pointer to the characters
+  \return pointer to the first character
+  */
+  char *data() noexcept {
+    return storage;
+  }
+
+  /** \brief Indexing operator
+  \param n index to the character
+  \return reference to the indexed character
+  */
+  char &operator[](size_t n) noexcept {
+    return storage[n];
+  }
+
+  /** \brief Const indexing operator
+  \param n index to the character
+  \return indexed character
+  */
+  char operator[](size_t n) const noexcept {
+    return storage[n];
+  }
+
+  /** \brief Span over the characters, excluding the terminating NUL
+  \return span over the characters
+  */
+  std::span<char> span() noexcept {
+    return std::span<char>(storage, length);
+  }
+
+  /** \brief Free part of the storage, including room for the terminating NUL, for use with the format.hpp functions
+  \return span over the free part of the storage
+  */
+  std::span<char> free() noexcept {
+    return std::span<char>(&storage[length], N + 1 - length);
+  }
+
+  /** \brief View of the characters
+  \return string view of the characters
+  */
+  operator std::string_view() const noexcept {
+    return std::string_view(storage, length);
+  }
+
+  /** \brief Compares the contents with a string
+  \param other string to compare with
+  \return true if the contents are equal
+  */
+  bool operator==(std::string_view other) const noexcept {
+    return std::string_view(storage, length) == other;
+  }
+
+ private:
+  char storage[N + 1]; /**< characters and terminating NUL */
+  size_t length = 0;   /**< amount of characters */
+};
+
+}  // namespace util
+
+#endif
@@ -0,0 +1,260 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file static_vector.hpp
+ *
+ * Variable length container with a fixed capacity, storage is part of the object so no heap is used
+ *
+ */
+#ifndef STATIC_VECTOR_HPP
+#define STATIC_VECTOR_HPP
+
+#include <cstddef>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace util {
+
+/**
+ * @brief Vector with a fixed capacity, modeled after std::vector
+ *
+ * Elements are constructed in place, operations that would exceed the capacity fail instead of allocating.
+ *
+ * @tparam T  element type
+ * @tparam N  capacity
+ */
+template <typename T, size_t N>
+class static_vector {
+ public:
+  /** \brief Shorthand for defining iterators */
+  using iterator = T *;
+  /** \brief Shorthand for defining const iterators */
+  using const_iterator = const T *;
+
+  static_vector() noexcept = default;
+
+  static_vector(const static_vector &other) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+    for (const T &element : other) emplace_back(element);
+  }
+
+  static_vector(static_vector &&other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    for (T &element : other) emplace_back(std::move(element));
+    other.clear();
+  }
+
+  static_vector &operator=(const static_vector &other) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+    if (this != &other) {
+      clear();
+      for (const T &element : other) emplace_back(element);
+    }
+    return *this;
+  }
+
+  static_vector &operator=(static_vector &&other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    if (this != &other) {
+      clear();
+      for (T &element : other) emplace_back(std::move(element));
+      other.clear();
+    }
+    return *this;
+  }
+
+  ~static_vector() {
+    clear();
+  }
+
+  /**
+   * @brief Constructs an element in place at the end
+   *
+   * @tparam Args   constructor argument types
+   * @param args    constructor arguments
+   * @return T*     constructed element, nullptr when the vector is full
+   */
+  template <typename... Args>
+  T *emplace_back(Args &&...args) {
+    if (count == N) return nullptr;
+    T *element = new (&storage[count * sizeof(T)]) T(std::forward<Args>(args)...);
+    count++;
+    return element;
+  }
+
+  /**
+   * @brief Copies an element to the end
+   *
+   * @param value   element to copy
+   * @return true   element added
+   * @return false  vector is full
+   */
+  bool push_back(const T &value) {
+    return emplace_back(value) != nullptr;
+  }
+
+  /**
+   * @brief Moves an element to the end
+   *
+   * @param value   element to move
+   * @return true   element added
+   * @return false  vector is full
+   */
+  bool push_back(T &&value) {
+    return emplace_back(std::move(value)) != nullptr;
+  }
+
+  /**
+   * @brief Destroys the last element, the vector must not be empty
+   *
+   */
+  void pop_back() noexcept {
+    count--;
+    data()[count].~T();
+  }
+
+  /**
+   * @brief Removes an element, the elements after it move one position forward
+   *
+   * @param position  element to remove
+   * @return iterator element following the removed element
+   */
+  iterator erase(const_iterator position) {
+    iterator current = begin() + (position - begin());
+    for (iterator i = current; i + 1 != end(); i++) *i = std::move(*(i + 1));
+    pop_back();
+    return current;
+  }
+
+  /**
+   * @brief Destroys all elements
+   *
+   */
+  void clear() noexcept {
+    while (count != 0) pop_back();
+  }
+
+  /** \brief Return amount of elements
+  \return amount of elements
+  */
+  constexpr size_t size() const noexcept {
+    return count;
+  }
+
+  /** \brief Return the capacity
+  \return maximum amount of elements
+  */
+  static constexpr size_t capacity() noexcept {
+    return N;
+  }
+
+  /** \brief Return if the vector is empty
+  \return true if the vector is empty
+  */
+  constexpr bool empty() const noexcept {
+    return count == 0;
+  }
+
+  /** \brief Return if the vector is full
+  \return true if no elements can be added
+  */
+  constexpr bool full() const noexcept {
+    return count == N;
+  }
+
+  /** \brief Return a pointer to the elements
+  \return pointer to the first element
+  */
+  T *data() noexcept {
+    return std::launder(reinterpret_cast<T *>(storage));
+  }
+
+  /** \brief Return a const pointer to the elements
+  \return const pointer to the first element
+  */
+  const T *data() const noexcept {
+    return std::launder(reinterpret_cast<const T *>(storage));
+  }
+
+  /** \brief Indexing operator
+  \param n index to the element
+  \return reference to the indexed element
+  */
+  T &operator[](size_t n) noexcept {
+    return data()[n];
+  }
+
+  /** \brief Const indexing operator
+  \param n index to the element
+  \return reference to the indexed element used for const vectors
+  */
+  const T &operator[](size_t n) const noexcept {
+    return data()[n];
+  }
+
+  /** \brief return first element
+  \return reference to the first element
+  */
+  T &front() noexcept {
+    return data()[0];
+  }
+
+  /** \brief return last element
+  \return reference to the last element
+  */
+  T &back() noexcept {
+    return data()[count - 1];
+  }
+
+  /** \brief return iterator to the first element
+  \return iterator to the first element
+  */
+  iterator begin() noexcept {
+    return data();
+  }
+
+  /** \brief return iterator beyond the last element
+  \return iterator beyond the last element
+  */
+  iterator end() noexcept {
+    return data() + count;
+  }
+
+  /** \brief return const iterator to the first element
+  \return const iterator to the first element
+  */
+  const_iterator begin() const noexcept {
+    return data();
+  }
+
+  /** \brief return const iterator beyond the last element
+  \return const iterator beyond the last element
+  */
+  const_iterator end() const noexcept {
+    return data() + count;
+  }
+
+  /** \brief Span over the elements
+  \return span over the elements
+  */
+  operator std::span<T>() noexcept {
+    return std::span<T>(data(), count);
+  }
+
+  /** \brief Const span over the elements
+  \return const span over the elements
+  */
+  operator std::span<const T>() const noexcept {
+    return std::span<const T>(data(), count);
+  }
+
+ private:
+  alignas(T) unsigned char storage[N * sizeof(T)]; /**< element storage */
+  size_t count = 0;                                /**< amount of constructed elements */
+};
+
+}  // namespace util
+
+#endif
@@ -0,0 +1,178 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file threadpool.hpp
+ *
+ * Small work stealing thread pool, only for hosts as it depends on the standard thread library
+ *
+ */
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <cstddef>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace util {
+
+/**
+ * @brief Thread pool where every worker has its own job queue
+ *
+ * Jobs are distributed round robin over the queues. A worker takes jobs from the back of its own queue and, when that is
+ * empty, steals jobs from the front of the other queues. A thread waiting for the pool helps executing jobs.
+ */
+class threadPool {
+ public:
+  /**
+   * @brief Starts the worker threads
+   *
+   * @param threadCount amount of worker threads, zero selects the amount of hardware threads
+   */
+  explicit threadPool(unsigned int threadCount = 0) {
+    if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+    for (unsigned int i = 0; i < threadCount; i++) queues.push_back(std::make_unique<workQueue>());
+    for (unsigned int i = 0; i < threadCount; i++) threads.emplace_back([this, i] { worker(i); });
+  }
+
+  threadPool(const threadPool &) = delete;
+  threadPool &operator=(const threadPool &) = delete;
+
+  /**
+   * @brief Finishes all pending jobs and stops the worker threads
+   *
+   */
+  ~threadPool() {
+    wait();
+    {
+      std::lock_guard<std::mutex> guard(signalLock);
+      stopping = true;
+    }
+    signal.notify_all();
+    for (std::thread &thread : threads) thread.join();
+  }
+
+  /**
+   * @brief Amount of worker threads
+   *
+   * @return unsigned int amount of worker threads
+   */
+  unsigned int size() const {
+    return static_cast<unsigned int>(threads.size());
+  }
+
+  /**
+   * @brief Adds a job to the pool
+   *
+   * @param job callable to execute on one of the workers
+   */
+  void submit(std::function<void()> job) {
+    pending++;
+    workQueue &queue = *queues[nextQueue++ % queues.size()];
+    {
+      // queued is changed under the queue lock, so a worker can not take the job before it is counted
+      std::lock_guard<std::mutex> guard(queue.lock);
+      queue.jobs.push_back(std::move(job));
+      std::lock_guard<std::mutex> signalGuard(signalLock);
+      queued++;
+    }
+    signal.notify_one();
+  }
+
+  /**
+   * @brief Waits until all submitted jobs are done, executing jobs while waiting
+   *
+   */
+  void wait() {
+    while (pending != 0) {
+      if (tryRun(0)) continue;
+      std::unique_lock<std::mutex> guard(signalLock);
+      done.wait(guard, [this] { return (pending == 0) || (queued != 0); });
+    }
+  }
+
+  /**
+   * @brief Executes a function for every index in a range on the pool and waits until all are done
+   *
+   * @tparam indexFunction  callable taking (unsigned int index)
+   * @param begin           first index
+   * @param end             one beyond the last index
+   * @param function        called for every index, calls can run concurrently
+   */
+  template <typename indexFunction>
+  void parallelFor(unsigned int begin, unsigned int end, indexFunction &&function) {
+    for (unsigned int i = begin; i < end; i++) submit([&function, i] { function(i); });
+    wait();
+  }
+
+ private:
+  struct workQueue {
+    std::mutex lock;
+    std::deque<std::function<void()>> jobs;
+  };
+
+  /**
+   * @brief Takes a job from the own queue or steals one from the others and executes it
+   *
+   * @param index   index of the own queue
+   * @return true   a job was executed
+   * @return false  no jobs were available
+   */
+  bool tryRun(unsigned int index) {
+    std::function<void()> job;
+    for (size_t i = 0; (i < queues.size()) && !job; i++) {
+      workQueue &queue = *queues[(index + i) % queues.size()];
+      std::lock_guard<std::mutex> guard(queue.lock);
+      if (queue.jobs.empty()) continue;
+      if (i == 0) {
+        job = std::move(queue.jobs.back());
+        queue.jobs.pop_back();
+      } else {
+        job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+      }
+      std::lock_guard<std::mutex> signalGuard(signalLock);
+      queued--;
+    }
+    if (!job) return false;
+    job();
+    if (--pending == 0) {
+      std::lock_guard<std::mutex> guard(signalLock);
+      done.notify_all();
+    }
+    return true;
+  }
+
+  void worker(unsigned int index) {
+    while (true) {
+      if (tryRun(index)) continue;
+      std::unique_lock<std::mutex> guard(signalLock);
+      signal.wait(guard, [this] { return stopping || (queued != 0); });
+      if (stopping && (queued == 0)) return;
+    }
+  }
+
+  std::vector<std::unique_ptr<workQueue>> queues; /**< job queue per worker */
+  std::vector<std::thread> threads;               /**< worker threads */
+  std::mutex signalLock;                          /**< protects queued and stopping, taken after a queue lock */
+  std::condition_variable signal;                 /**< signals workers that jobs are queued or the pool stops */
+  std::condition_variable done;                   /**< signals waiting threads that all jobs are done */
+  std::atomic<size_t> pending{0};                 /**< jobs submitted but not finished */
+  std::atomic<size_t> nextQueue{0};               /**< queue the next job is submitted to */
+  size_t queued = 0;                              /**< jobs in the queues, not yet taken */
+  bool stopping = false;                          /**< pool is being destroyed */
+};
+
+}  // namespace util
+
+#endif
@@ -0,0 +1,252 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file timerwheel.hpp
+ *
+ * Hierarchical timer wheel, schedules deferred work with constant time start and cancel
+ *
+ */
+#ifndef TIMERWHEEL_HPP
+#define TIMERWHEEL_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <array.hpp>
+#include <sq_coro.hpp>
+
+namespace util {
+
+/**
+ * @brief Link of the intrusive timer lists, also used as list head of the wheel slots
+ *
+ */
+struct timerLink {
+  timerLink *next = this; /**< next entry in the list */
+  timerLink *prev = this; /**< previous entry in the list */
+
+  timerLink() noexcept = default;
+  timerLink(const timerLink &) = delete;
+  timerLink &operator=(const timerLink &) = delete;
+
+  bool linked() const noexcept {
+    return next != this;
+  }
+
+  void unlink() noexcept {
+    prev->next = next;
+    next->prev = prev;
+    next = this;
+    prev = this;
+  }
+
+  void insertBefore(timerLink &position) noexcept {
+    next = &position;
+    prev = position.prev;
+    position.prev->next = this;
+    position.prev = this;
+  }
+};
+
+/**
+ * @brief Timer, owned by the user and linked into a timer wheel while running
+ *
+ * The callback has the same signature as the C style callbacks of the library, so util::signalCallback can wake up a
+ * scheduler task:
+ *
+ *   util::timer debounce{util::signalCallback<decltype(sched), buttonEvent>, &sched};
+ *   wheel.start(debounce, 20);
+ *
+ * Without a callback the timer only sets its expired flag, which coroutines can wait on with CR_WAIT_TIMER.
+ */
+class timer : private timerLink {
+ public:
+  using callbackFunction = void (*)(void *); /**< function called when the timer expires */
+
+  timer() noexcept = default;
+
+  /**
+   * @brief Creates a timer with a callback
+   *
+   * @param callback  called from tick when the timer expires, may start or cancel timers
+   * @param context   passed to the callback
+   */
+  timer(callbackFunction callback, void *context) noexcept : callback{callback}, context{context} {}
+
+  ~timer() {
+    unlink();
+  }
+
+  /**
+   * @brief Checks if the timer is running
+   *
+   * @return true timer is linked into a wheel and did not expire yet
+   */
+  bool pending() const noexcept {
+    return linked();
+  }
+
+  /**
+   * @brief Checks if the timer expired since it was last started
+   *
+   * @return true timer expired
+   */
+  bool expired() const noexcept {
+    return fired;
+  }
+
+ private:
+  template <unsigned, unsigned>
+  friend class timerWheel;
+
+  uint32_t expires = 0;                /**< tick at which the timer expires */
+  callbackFunction callback = nullptr; /**< called on expiry, may be nullptr */
+  void *context = nullptr;             /**< passed to the callback */
+  bool fired = false;                  /**< timer expired since it was started */
+};
+
+/**
+ * @brief Hierarchical timer wheel with a fixed amount of slots and any amount of timers
+ *
+ * The first level has a slot for every tick, every next level has slots covering a whole rotation of the level below.
+ * Starting and cancelling a timer links or unlinks it from a slot. A tick runs the timers in one slot of the first level,
+ * when the first level wraps around the timers of the next level slot are moved down. Every timer is moved at most once
+ * per level, so a tick takes amortized constant time however many timers are running. Timers further away then the
+ * range of the wheel are parked in the last level and moved until they are in range.
+ *
+ * The wheel is not thread or interrupt safe, start, cancel and tick must be called from the same context. Typically tick
+ * is called from the main loop for every tick of the scheduler or systick counter.
+ *
+ * @tparam slotBits log2 of the amount of slots per level
+ * @tparam levels   amount of levels
+ */
+template <unsigned slotBits = 6, unsigned levels = 4>
+class timerWheel {
+ public:
+  static_assert((slotBits > 0) && (levels > 0) && (slotBits * levels <= 32), "wheel range must fit in 32 bits");
+
+  timerWheel() noexcept = default;
+  timerWheel(const timerWheel &) = delete;
+  timerWheel &operator=(const timerWheel &) = delete;
+
+  /**
+   * @brief Starts a timer, a running timer is restarted
+   *
+   * @param entry timer to start
+   * @param ticks amount of ticks until the timer expires, 0 expires on the next tick
+   */
+  void start(timer &entry, uint32_t ticks) noexcept {
+    entry.unlink();
+    entry.fired = false;
+    entry.expires = now + (ticks == 0 ? 1 : ticks);
+    place(entry);
+  }
+
+  /**
+   * @brief Stops a timer, nothing happens when the timer is not running
+   *
+   * @param entry timer to stop
+   */
+  void cancel(timer &entry) noexcept {
+    entry.unlink();
+  }
+
+  /**
+   * @brief Advances the time by one tick and runs the expired timers
+   *
+   */
+  void tick() {
+    now++;
+    const uint32_t index = now & slotMask;
+    if (index == 0) cascade();
+    timerLink expired;
+    moveSlot(slots[index], expired);
+    while (expired.linked()) {
+      timer &entry = static_cast<timer &>(*expired.next);
+      entry.unlink();
+      entry.fired = true;
+      if (entry.callback != nullptr) entry.callback(entry.context);
+    }
+  }
+
+  /**
+   * @brief Advances the time by multiple ticks
+   *
+   * @param ticks amount of ticks passed
+   */
+  void advance(uint32_t ticks) {
+    while (ticks-- != 0) tick();
+  }
+
+  /**
+   * @brief Current time of the wheel
+   *
+   * @return uint32_t ticks since the start, wraps around
+   */
+  uint32_t time() const noexcept {
+    return now;
+  }
+
+ private:
+  static constexpr uint32_t slotCount = 1u << slotBits;                              /**< slots per level */
+  static constexpr uint32_t slotMask = slotCount - 1;                                /**< slot index mask */
+  static constexpr uint64_t range = static_cast<uint64_t>(1) << (slotBits * levels); /**< ticks covered by the wheel */
+
+  void place(timer &entry) noexcept {
+    const uint32_t delta = entry.expires - now;
+    uint32_t position = entry.expires;
+    if (static_cast<uint64_t>(delta) >= range) position = now + static_cast<uint32_t>(range - 1);
+    const uint64_t distance = position - now;
+    unsigned level = 0;
+    while ((level < levels - 1) && (distance >= (static_cast<uint64_t>(1) << (slotBits * (level + 1))))) level++;
+    const uint32_t index = (position >> (slotBits * level)) & slotMask;
+    entry.insertBefore(slots[level * slotCount + index]);
+  }
+
+  void cascade() noexcept {
+    for (unsigned level = 1; level < levels; level++) {
+      const uint32_t index = (now >> (slotBits * level)) & slotMask;
+      timerLink moved;
+      moveSlot(slots[level * slotCount + index], moved);
+      while (moved.linked()) {
+        timer &entry = static_cast<timer &>(*moved.next);
+        entry.unlink();
+        place(entry);
+      }
+      if (index != 0) break;
+    }
+  }
+
+  static void moveSlot(timerLink &slot, timerLink &destination) noexcept {
+    if (!slot.linked()) return;
+    destination.next = slot.next;
+    destination.prev = slot.prev;
+    slot.next->prev = &destination;
+    slot.prev->next = &destination;
+    slot.next = &slot;
+    slot.prev = &slot;
+  }
+
+  array<timerLink, slotCount * levels> slots; /**< list heads of the slots, level by level */
+  uint32_t now = 0;                           /**< ticks since the start */
+};
+
+}  // namespace util
+
+/**
+ * @brief Waits in a coroutine until a timer expires, the wheel is ticked elsewhere
+ *
+ * @param wheel timer wheel to start the timer on
+ * @param entry timer to wait on, must outlive the wait
+ * @param ticks amount of ticks to wait
+ */
+#define CR_WAIT_TIMER(wheel, entry, ticks) \
+  do {                                     \
+    (wheel).start(entry, ticks);           \
+    CR_WAIT_V((entry).expired());          \
+  } while (0)
+
+#endif
@@ -0,0 +1,250 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file transport.hpp
+ *
+ * Scatter gather transports for device drivers, a transaction is sent as a list of buffer segments without copying
+ *
+ */
+#ifndef TRANSPORT_HPP
+#define TRANSPORT_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <concepts>
+#include <span>
+#include <array.hpp>
+#include <atomic.hpp>
+#include <results.h>
+
+namespace util {
+
+template <typename T>
+using transferSegment = std::span<const T>; /**< contiguous part of a transaction */
+
+template <typename T>
+using transferSegments = std::span<const transferSegment<T>>; /**< all segments of a transaction */
+
+/**
+ * @brief Transport sending transactions of T elements, like an SPI or I2C bus with a selected device
+ *
+ * A transaction is the whole of chip select or start condition until deselect or stop. Device selection is up to the
+ * transport, for example an I2C transport is created for one device address. transfer returns as soon as the transaction
+ * is started, the data of the segments must stay valid until busy returns false. The segment list itself is copied by the
+ * transport. A transfer waits until the previous one is done.
+ *
+ * @tparam transportType  transport to check
+ * @tparam T              element type of the transactions
+ */
+template <typename transportType, typename T>
+concept transport = requires(transportType &bus, transferSegments<T> segments) {
+  requires std::same_as<typename transportType::elementType, T>;
+  { bus.transfer(segments) } -> std::same_as<result>;
+  { bus.busy() } -> std::convertible_to<bool>;
+};
+
+/**
+ * @brief Transport sending every segment with blocking writes
+ *
+ * The hardware has start(), write(std::span<const T>) and stop() members, write returns when the segment is sent.
+ *
+ * @tparam T        element type
+ * @tparam hardware bus access of the board
+ */
+template <typename T, typename hardware>
+class blockingTransport {
+ public:
+  using elementType = T; /**< element type of the transactions */
+
+  explicit blockingTransport(hardware &port) noexcept : port{port} {}
+
+  /**
+   * @brief Sends a transaction, returns when it is done
+   *
+   * @param segments  segments of the transaction
+   * @return result   noError
+   */
+  result transfer(transferSegments<T> segments) {
+    port.start();
+    for (const transferSegment<T> &segment : segments) {
+      if (!segment.empty()) port.write(segment);
+    }
+    port.stop();
+    return noError;
+  }
+
+  /**
+   * @brief Blocking transports are never busy
+   *
+   * @return false  transaction is done
+   */
+  bool busy() const noexcept {
+    return false;
+  }
+
+ private:
+  hardware &port; /**< bus access */
+};
+
+/**
+ * @brief Transport sending elements from the transmit interrupt
+ *
+ * The hardware has start() and stop() members, start begins the transaction and enables the transmit interrupt. The
+ * interrupt handler writes elements from next until it returns false, then disables the interrupt:
+ *
+ *   void SPI0_IRQHandler() {
+ *     uint16_t element;
+ *     if (bus.next(element)) SPI0->TXDAT = element; else disableTransmitInterrupt();
+ *   }
+ *
+ * @tparam T            element type
+ * @tparam maxSegments  maximum amount of segments per transaction
+ * @tparam hardware     bus access of the board
+ */
+template <typename T, size_t maxSegments, typename hardware>
+class interruptTransport {
+ public:
+  using elementType = T; /**< element type of the transactions */
+
+  explicit interruptTransport(hardware &port) noexcept : port{port} {}
+
+  /**
+   * @brief Starts a transaction, waits for the previous one to be done
+   *
+   * @param segments  segments of the transaction
+   * @return result   noError, invalidArg when there are more then maxSegments segments
+   */
+  result transfer(transferSegments<T> segments) {
+    if (segments.size() > maxSegments) return invalidArg;
+    while (busy()) {
+    }
+    copySegments(segments);
+    active.store(true, memory_order::release);
+    port.start();
+    return noError;
+  }
+
+  /**
+   * @brief Next element to send, only for the transmit interrupt
+   *
+   * @param element destination of the element
+   * @return true   element to send
+   * @return false  transaction done, the hardware is stopped
+   */
+  bool next(T &element) {
+    while (current < count) {
+      if (position < segments[current].size()) {
+        element = segments[current][position++];
+        return true;
+      }
+      current++;
+      position = 0;
+    }
+    if (active.load(memory_order::relaxed)) {
+      port.stop();
+      active.store(false, memory_order::release);
+    }
+    return false;
+  }
+
+  /**
+   * @brief Checks if a transaction is in progress
+   *
+   * @return true transaction in progress, segment data still in use
+   */
+  bool busy() const noexcept {
+    return active.load(memory_order::acquire);
+  }
+
+ private:
+  void copySegments(transferSegments<T> newSegments) noexcept {
+    for (size_t i = 0; i < newSegments.size(); i++) segments[i] = newSegments[i];
+    count = newSegments.size();
+    current = 0;
+    position = 0;
+  }
+
+  hardware &port;                                   /**< bus access */
+  array<transferSegment<T>, maxSegments> segments;  /**< segments of the current transaction */
+  size_t count = 0;                                 /**< amount of segments */
+  size_t current = 0;                               /**< segment being sent */
+  size_t position = 0;                              /**< next element in the current segment */
+  atomic<bool> active{false};                       /**< transaction in progress */
+};
+
+/**
+ * @brief Transport sending segments with DMA, the CPU is free while a segment is sent
+ *
+ * The hardware has start(), startBlock(std::span<const T>) and stop() members. startBlock starts a DMA transfer of one
+ * segment, the DMA done interrupt handler calls blockDone which starts the next segment or ends the transaction.
+ *
+ * @tparam T            element type
+ * @tparam maxSegments  maximum amount of segments per transaction
+ * @tparam hardware     bus access of the board
+ */
+template <typename T, size_t maxSegments, typename hardware>
+class dmaTransport {
+ public:
+  using elementType = T; /**< element type of the transactions */
+
+  explicit dmaTransport(hardware &port) noexcept : port{port} {}
+
+  /**
+   * @brief Starts a transaction, waits for the previous one to be done
+   *
+   * @param segments  segments of the transaction
+   * @return result   noError, invalidArg when there are more then maxSegments segments
+   */
+  result transfer(transferSegments<T> segments) {
+    if (segments.size() > maxSegments) return invalidArg;
+    while (busy()) {
+    }
+    count = 0;
+    for (const transferSegment<T> &segment : segments) {
+      if (!segment.empty()) this->segments[count++] = segment;
+    }
+    if (count == 0) return noError;
+    current = 0;
+    active.store(true, memory_order::release);
+    port.start();
+    port.startBlock(this->segments[0]);
+    return noError;
+  }
+
+  /**
+   * @brief Starts the next segment or ends the transaction, only for the DMA done interrupt
+   *
+   */
+  void blockDone() {
+    if (++current < count) {
+      port.startBlock(segments[current]);
+      return;
+    }
+    port.stop();
+    active.store(false, memory_order::release);
+  }
+
+  /**
+   * @brief Checks if a transaction is in progress
+   *
+   * @return true transaction in progress, segment data still in use
+   */
+  bool busy() const noexcept {
+    return active.load(memory_order::acquire);
+  }
+
+ private:
+  hardware &port;                                   /**< bus access */
+  array<transferSegment<T>, maxSegments> segments;  /**< non empty segments of the current transaction */
+  size_t count = 0;                                 /**< amount of segments */
+  size_t current = 0;                               /**< segment being sent */
+  atomic<bool> active{false};                       /**< transaction in progress */
+};
+
+}  // namespace util
+
+#endif
@@ -18,12 +18,14 @@ $(NAME)_LIB_FILES := $(LIB_DIR)/src/ansi/parse_ansi.c \
 $(LIB_DIR)/src/queue/queue_string.c \
 $(LIB_DIR)/src/queue/queue_char.c \
 $(LIB_DIR)/src/queue/queue_uint8.c \
+$(LIB_DIR)/src/queue/queue_record.c \
 $(LIB_DIR)/src/cmdline/cmdline_prompt.c \
 $(LIB_DIR)/src/prompt/prompt_mini.c \
 $(LIB_DIR)/src/command/command_mini.c \
 $(LIB_DIR)/src/datastream/dswritechar.c \
 $(LIB_DIR)/src/datastream/dsreadchar.c \
 $(LIB_DIR)/src/datastream/dsputs.c \
+$(LIB_DIR)/src/datastream/dsnotify.c \
 $(LIB_DIR)/src/print/print_digit.c \
 $(LIB_DIR)/src/print/print_hex_u8.c \
 $(LIB_DIR)/src/print/print_hex_u16.c \
@@ -30,6 +30,7 @@ SOFTWARE.
 #include <queue_string.h>
 #include <cmdline.h>
 #include <datastream.h>
+#include <cmdline_prompt.h>
 
 #define ASCII_NUL (0)
 #define ASCII_BS (8)      // backspace
@@ -57,7 +58,7 @@ void cmdlinePromptInit(t_queueString *q) {
 /*
  * Delete characters prompt and history
  */
-static void cmdlinePromptDel(datastreamChar_t *stream, uint16_t *promptBufIdx, uint16_t count) {
+static void cmdlinePromptDel(const datastreamChar_t *stream, uint16_t *promptBufIdx, uint16_t count) {
   for (uint16_t i = 0; i < count; i++) {
     dsWriteChar(stream, ASCII_BS);
     dsWriteChar(stream, ASCII_SPACE);
@@ -70,7 +71,7 @@ static void cmdlinePromptDel(datastreamChar_t *stream, uint16_t *promptBufIdx, u
 /*
  * Add character to prompt
  */
-static void cmdlinePromptAdd(datastreamChar_t *stream, char *promptBuf, uint16_t *promptBufIdx, char c) {
+static void cmdlinePromptAdd(const datastreamChar_t *stream, char *promptBuf, uint16_t *promptBufIdx, char c) {
   if (*promptBufIdx < CMDLINE_MAX_LENGTH - 1) {
     dsWriteChar(stream, c);
     promptBuf[*promptBufIdx] = c;
@@ -81,7 +82,7 @@ static void cmdlinePromptAdd(datastreamChar_t *stream, char *promptBuf, uint16_t
 /*
  * Add character to prompt
  */
-static void cmdlinePromptAddString(datastreamChar_t *stream, char *promptBuf, uint16_t *promptBufIdx, char *s) {
+static void cmdlinePromptAddString(const datastreamChar_t *stream, char *promptBuf, uint16_t *promptBufIdx, char *s) {
   while (*s != ASCII_NUL) {
     dsWriteChar(stream, *s);
     promptBuf[*promptBufIdx] = *s;
@@ -91,16 +92,11 @@ static void cmdlinePromptAddString(datastreamChar_t *stream, char *promptBuf, ui
 }
 
 /*
- *  Prompt handler, call when new character is received
+ *  Handle a single character read from the stream
  */
-result cmdlinePromptProcess(datastreamChar_t *stream, result (*cmdlineParse)(char *cmdline)) {
+static void cmdlinePromptChar(const datastreamChar_t *stream, result (*cmdlineParse)(char *cmdline), char c) {
   static char currentPrompt[CMDLINE_MAX_LENGTH];
   static promptState_t promptState = promptNormal;
-  char c;
-  result r = dsReadChar(stream, &c);
-  if (r != noError) {
-    return r;
-  }
 
   // handling functions for escape sequences
   switch (promptState) {
@@ -116,7 +112,7 @@ result cmdlinePromptProcess(datastreamChar_t *stream, result (*cmdlineParse)(cha
           // check length
           if (strlen(currentPrompt) == 0)
             // zero length string, do nothing
-            return noError;
+            return;
           // add to history
           queueStringEnqueue(commandHistory, currentPrompt);
           // execute
@@ -175,5 +171,33 @@ result cmdlinePromptProcess(datastreamChar_t *stream, result (*cmdlineParse)(cha
       // TODO assert
       break;
   }
+}
+
+/*
+ *  Prompt handler, call when new character is received
+ */
+result cmdlinePromptProcess(const datastreamChar_t *stream, result (*cmdlineParse)(char *cmdline)) {
+  char c;
+  result r = dsReadChar(stream, &c);
+  if (r != noError) {
+    return r;
+  }
+  cmdlinePromptChar(stream, cmdlineParse, c);
+  return noError;
+}
+
+/*
+ *  Prompt handler for notified streams, handles at most maxCharacters characters
+ */
+result cmdlinePromptProcessBatch(const datastreamChar_t *stream, result (*cmdlineParse)(char *cmdline),
+                                 unsigned int maxCharacters) {
+  for (unsigned int i = 0; i < maxCharacters; i++) {
+    char c;
+    result r = dsReadChar(stream, &c);
+    if (r != noError) {
+      return r;
+    }
+    cmdlinePromptChar(stream, cmdlineParse, c);
+  }
   return noError;
 }
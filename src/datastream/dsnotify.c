@@ -0,0 +1,31 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file dsnotify.c
+ *
+ * Datastream notification functions
+ *
+ */
+
+#include <datastream_notify.h>
+
+void dsNotifyInit(datastreamNotifier_t *notifier, void (*callback)(void *context), void *context) {
+  notifier->callback = callback;
+  notifier->context = context;
+  notifier->pending = false;
+}
+
+void dsNotify(datastreamNotifier_t *notifier) {
+  notifier->pending = true;
+  if (notifier->callback != NULL) notifier->callback(notifier->context);
+}
+
+bool dsNotifyTake(datastreamNotifier_t *notifier) {
+  if (!notifier->pending) return false;
+  notifier->pending = false;
+  return true;
+}
@@ -30,12 +30,10 @@ SOFTWARE.
 #define ASCII_CR ('\r')  // Carriage Return
 #define ASCII_LF ('\n')  // Line Feed
 
-result promptProcess(promptData_t *const promptData, const datastreamChar_t *stream) {
-  char c;
-  result r = dsReadChar(stream, &c);
-  if (r != noError) {
-    return r;
-  }
+/*
+ * Handle a single character read from the stream
+ */
+static result promptProcessChar(promptData_t *const promptData, const datastreamChar_t *stream, char c) {
   switch (c) {
     case ASCII_CR:
       dsWriteChar(stream, ASCII_CR);
@@ -63,4 +61,23 @@ result promptProcess(promptData_t *const promptData, const datastreamChar_t *str
       break;
   }
   return noError;
-}
\ No newline at end of file
+}
+
+result promptProcess(promptData_t *const promptData, const datastreamChar_t *stream) {
+  char c;
+  result r = dsReadChar(stream, &c);
+  if (r != noError) {
+    return r;
+  }
+  return promptProcessChar(promptData, stream, c);
+}
+
+result promptProcessBatch(promptData_t *const promptData, const datastreamChar_t *stream, unsigned int maxCharacters) {
+  for (unsigned int i = 0; i < maxCharacters; i++) {
+    char c;
+    result r = dsReadChar(stream, &c);
+    if (r != noError) return r;
+    promptProcessChar(promptData, stream, c);
+  }
+  return noError;
+}
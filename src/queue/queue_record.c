@@ -0,0 +1,115 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file queue_record.c
+ *
+ * Queue of variable length binary records
+ *
+ */
+
+#include <results.h>
+#include <queue_record.h>
+#include <string.h>
+#include <stddef.h>
+
+#define PREFIX_SIZE (2)          // size of the length prefix
+#define WRAP_MARKER (0xFFFFu)    // length prefix marking the rest of the buffer as skipped
+
+// helper functions
+// read length prefix at index
+static uint16_t ReadPrefix(const t_queueRecord *restrict queue, uint16_t idx) {
+  return (uint16_t)(queue->data[idx] | (queue->data[idx + 1] << 8));
+}
+
+// write length prefix at index
+static void WritePrefix(t_queueRecord *restrict queue, uint16_t idx, uint16_t length) {
+  queue->data[idx] = (uint8_t)length;
+  queue->data[idx + 1] = (uint8_t)(length >> 8);
+}
+
+// bytes from idx to the end of the buffer that are skipped, 0 when a record starts at idx
+static uint16_t SkippedAt(const t_queueRecord *restrict queue, uint16_t idx) {
+  uint16_t end = (uint16_t)(queue->mask + 1 - idx);
+  if ((end < PREFIX_SIZE) || (ReadPrefix(queue, idx) == WRAP_MARKER)) return end;
+  return 0;
+}
+
+// index of the oldest record, the queue must not be empty
+static uint16_t OldestRecord(const t_queueRecord *restrict queue) {
+  return (SkippedAt(queue, queue->tail) != 0) ? 0 : queue->tail;
+}
+
+void queueRecordInit(t_queueRecord *restrict queue) {
+  queue->head = 0;
+  queue->tail = 0;
+  queue->used = 0;
+  queue->count = 0;
+}
+
+result queueRecordSkip(t_queueRecord *restrict queue) {
+  if (queue == NULL) return invalidArg;
+  if (queue->count == 0) return queueEmpty;
+  uint16_t skipped = SkippedAt(queue, queue->tail);
+  uint16_t idx = (skipped != 0) ? 0 : queue->tail;
+  uint16_t recordSize = PREFIX_SIZE + ReadPrefix(queue, idx);
+  queue->used = (uint16_t)(queue->used - skipped - recordSize);
+  queue->count--;
+  if (queue->count == 0) {
+    // restart at the beginning, so the whole buffer is contiguous again
+    queueRecordInit(queue);
+  } else {
+    queue->tail = (idx + recordSize) & queue->mask;
+  }
+  return noError;
+}
+
+result queueRecordEnqueue(t_queueRecord *restrict queue, const uint8_t *restrict record, uint16_t length) {
+  if ((queue == NULL) || ((record == NULL) && (length != 0))) return invalidArg;
+  uint32_t size = (uint32_t)queue->mask + 1;
+  uint32_t recordSize = PREFIX_SIZE + (uint32_t)length;
+  if ((length >= WRAP_MARKER) || (recordSize > size)) return dataInvalid;
+
+  uint32_t end;
+  uint32_t skipped;
+  while (1) {
+    end = size - queue->head;
+    skipped = (recordSize > end) ? end : 0;
+    if ((queue->used + skipped + recordSize) <= size) break;
+    if ((queue->policy != queueRecordOverwrite) || (queue->count == 0)) return queueFull;
+    queueRecordSkip(queue);
+  }
+  if (skipped != 0) {
+    if (end >= PREFIX_SIZE) WritePrefix(queue, queue->head, WRAP_MARKER);
+    queue->head = 0;
+  }
+  WritePrefix(queue, queue->head, length);
+  if (length != 0) memcpy(&(queue->data[queue->head + PREFIX_SIZE]), record, length);
+  queue->head = (uint16_t)((queue->head + recordSize) & queue->mask);
+  queue->used = (uint16_t)(queue->used + skipped + recordSize);
+  queue->count++;
+  return noError;
+}
+
+result queueRecordPeek(const t_queueRecord *restrict queue, const uint8_t **restrict record, uint16_t *restrict length) {
+  if ((queue == NULL) || (record == NULL) || (length == NULL)) return invalidArg;
+  if (queue->count == 0) return queueEmpty;
+  uint16_t idx = OldestRecord(queue);
+  *length = ReadPrefix(queue, idx);
+  *record = &(queue->data[idx + PREFIX_SIZE]);
+  return noError;
+}
+
+result queueRecordDequeue(t_queueRecord *restrict queue, uint8_t *restrict record, uint16_t size,
+                          uint16_t *restrict length) {
+  if ((queue == NULL) || (record == NULL) || (length == NULL)) return invalidArg;
+  const uint8_t *oldest;
+  result r = queueRecordPeek(queue, &oldest, length);
+  if (r != noError) return r;
+  if (*length > size) return dataInvalid;
+  memcpy(record, oldest, *length);
+  return queueRecordSkip(queue);
+}
@@ -0,0 +1,219 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file bitblit_differential.cpp
+ *
+ * Runs every bitblit and fill variant against the pixel at a time references, reports mismatches and throughput
+ *
+ * Usage: bitblit_differential [cases] [seed], returns 1 when any variant mismatches
+ *
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <bitblit.hpp>
+#include <bit/bitblit1d.hpp>
+#include <bit/bitblit2dfast.hpp>
+#include <bit/bitblit2dsmall.hpp>
+#include <bit/bitblitmasked.hpp>
+#include <bit/bitblitoriented.hpp>
+#include <bit/fill.hpp>
+#include <bit/bitblitdifferential.hpp>
+
+using namespace util;
+using namespace util::reference;
+
+namespace {
+
+size_t caseCount = 20000;
+uint32_t seed = 1;
+size_t failedVariants = 0;
+
+void report(const char *name, const char *types, const differentialResult &result) {
+  std::printf("%-18s %-8s cases %6zu mismatches %6zu %8.1f MPix/s\n", name, types, result.cases, result.mismatches,
+              result.megaPixelsPerSecond());
+  if (result.mismatches == 0) return;
+  failedVariants++;
+  const blitCase &c = result.firstMismatch;
+  std::printf("  first mismatch: destStride %u destWidth %u destHeight %u destX %d destY %d srcStride %u srcX %u srcY %u "
+              "srcWidth %u srcHeight %u op %d\n",
+              c.destStride, c.destWidth, c.destHeight, c.destX, c.destY, c.srcStride, c.srcX, c.srcY, c.srcWidth, c.srcHeight,
+              static_cast<int>(c.op));
+}
+
+template <typename destType, typename srcType>
+void runTemplateVariants(const char *types) {
+  const blitCaseLimits all;
+  report("bitblit2dfast", types,
+         differentialRun<destType, srcType>(
+             [](destType *dest, const srcType *src, const srcType *, const blitCase &c) {
+               bitblit2dfast(dest, c.destStride, c.destWidth, c.destHeight, c.destX, c.destY, src, c.srcStride, c.srcX,
+                             c.srcY, c.srcWidth, c.srcHeight, c.op);
+             },
+             all, caseCount, seed));
+
+  blitCaseLimits masked;
+  masked.masked = true;
+  report("bitblit2dmasked", types,
+         differentialRun<destType, srcType>(
+             [](destType *dest, const srcType *src, const srcType *mask, const blitCase &c) {
+               bitblit2dmasked(dest, c.destStride, c.destWidth, c.destHeight, c.destX, c.destY, src, mask, c.srcStride, c.srcX,
+                               c.srcY, c.srcWidth, c.srcHeight, c.op);
+             },
+             masked, caseCount, seed));
+
+  // small takes unsigned positions, clipping is only at the right and bottom edge
+  blitCaseLimits small;
+  small.negativePositions = false;
+  report("bitblit2dsmall", types,
+         differentialRun<destType, srcType>(
+             [](destType *dest, const srcType *src, const srcType *, const blitCase &c) {
+               bitblit2dsmall(dest, c.destStride, c.destWidth, c.destHeight, static_cast<unsigned int>(c.destX),
+                              static_cast<unsigned int>(c.destY), src, c.srcStride, c.srcX, c.srcY, c.srcWidth, c.srcHeight,
+                              c.op);
+             },
+             small, caseCount, seed));
+
+  blitCaseLimits oriented;
+  oriented.orientations = true;
+  report("bitblit2doriented", types,
+         differentialRun<destType, srcType>(
+             [](destType *dest, const srcType *src, const srcType *, const blitCase &c) {
+               bitblit2doriented(dest, c.destStride, c.destWidth, c.destHeight, c.destX, c.destY, src, c.srcStride, c.srcX,
+                                 c.srcY, c.srcWidth, c.srcHeight, c.orientation, c.op);
+             },
+             [](destType *dest, const srcType *src, const srcType *, const blitCase &c) {
+               reference::bitblit2doriented<false>(dest, c.destStride, c.destWidth, c.destHeight, c.destX, c.destY, src,
+                                                   c.srcStride, c.srcX, c.srcY, c.srcWidth, c.srcHeight, c.orientation, c.op);
+             },
+             oriented, caseCount, seed));
+
+  // the 1d blitter reads the source from bit 0 and writes a single row
+  blitCaseLimits row;
+  row.negativePositions = false;
+  row.sourceOrigin = false;
+  row.destinationPadding = false;
+  row.maxDestHeight = 1;
+  row.maxSrcHeight = 1;
+  report("bitblit1d", types,
+         differentialRun<destType, srcType>(
+             [](destType *dest, const srcType *src, const srcType *, const blitCase &c) {
+               bitblit1d(dest, c.destWidth, static_cast<unsigned int>(c.destX), src, c.srcWidth, c.op);
+             },
+             row, caseCount, seed));
+}
+
+template <typename srcType>
+void runPagedVariants(const char *types) {
+  blitCaseLimits paged;
+  paged.orientations = true;
+  paged.pagedDestination = true;
+  report("bitblit2dpaged", types,
+         differentialRun<uint8_t, srcType>(
+             [](uint8_t *dest, const srcType *src, const srcType *, const blitCase &c) {
+               bitblit2dpaged(dest, c.destStride, c.destWidth, c.destHeight, c.destX, c.destY, src, c.srcStride, c.srcX, c.srcY,
+                              c.srcWidth, c.srcHeight, c.orientation, c.op);
+             },
+             [](uint8_t *dest, const srcType *src, const srcType *, const blitCase &c) {
+               reference::bitblit2doriented<true>(dest, c.destStride, c.destWidth, c.destHeight, c.destX, c.destY, src,
+                                                  c.srcStride, c.srcX, c.srcY, c.srcWidth, c.srcHeight, c.orientation, c.op);
+             },
+             paged, caseCount, seed));
+}
+
+// fills use the source as pattern and srcWidth, srcHeight as rectangle size
+template <typename destType>
+void runFillVariants(const char *types) {
+  blitCaseLimits fill;
+  fill.pattern = true;
+  fill.sourceOrigin = false;
+  report("fillRectClipped", types,
+         differentialRun<destType, destType>(
+             [](destType *dest, const destType *pattern, const destType *, const blitCase &c) {
+               detail::fillRectClipped(dest, c.destStride, c.destWidth, c.destHeight, c.destX, c.destY, c.srcWidth,
+                                       c.srcHeight, pattern, c.patternLength, c.op);
+             },
+             [](destType *dest, const destType *pattern, const destType *, const blitCase &c) {
+               reference::fillRect<false>(dest, c.destStride, c.destWidth, c.destHeight, c.destX, c.destY, c.srcWidth,
+                                          c.srcHeight, pattern, c.patternLength, c.op);
+             },
+             fill, caseCount, seed));
+}
+
+void runPagedFillVariants() {
+  // pages are exactly destWidth bytes
+  blitCaseLimits fill;
+  fill.pattern = true;
+  fill.sourceOrigin = false;
+  fill.pagedDestination = true;
+  fill.destinationPadding = false;
+  report("fillRectPaged", "u8", differentialRun<uint8_t, uint8_t>(
+                                     [](uint8_t *dest, const uint8_t *pattern, const uint8_t *, const blitCase &c) {
+                                       detail::fillRectPagedClipped(dest, c.destWidth, c.destHeight, c.destX, c.destY,
+                                                                    c.srcWidth, c.srcHeight, pattern, c.patternLength, c.op);
+                                     },
+                                     [](uint8_t *dest, const uint8_t *pattern, const uint8_t *, const blitCase &c) {
+                                       reference::fillRect<true>(dest, c.destStride, c.destWidth, c.destHeight, c.destX,
+                                                                 c.destY, c.srcWidth, c.srcHeight, pattern, c.patternLength,
+                                                                 c.op);
+                                     },
+                                     fill, caseCount, seed));
+}
+
+void runByteVariants() {
+  blitCaseLimits stride;
+  stride.negativePositions = false;
+  report("bitblit2d stride", "u8<u8", differentialRun<uint8_t, uint8_t>(
+                                          [](uint8_t *dest, const uint8_t *src, const uint8_t *, const blitCase &c) {
+                                            bitblit2d(dest, c.destStride, c.destWidth, c.destHeight,
+                                                      static_cast<unsigned int>(c.destX), static_cast<unsigned int>(c.destY),
+                                                      src, c.srcStride, c.srcX, c.srcY, c.srcWidth, c.srcHeight, c.op);
+                                          },
+                                          stride, caseCount, seed));
+
+  // every source row starts on a new byte, the block is taken from the source origin
+  blitCaseLimits legacy;
+  legacy.negativePositions = false;
+  legacy.packedSource = false;
+  legacy.sourceOrigin = false;
+  legacy.destinationPadding = false;
+  report("bitblit2d legacy", "u8<u8", differentialRun<uint8_t, uint8_t>(
+                                          [](uint8_t *dest, const uint8_t *src, const uint8_t *, const blitCase &c) {
+                                            bitblit2d(dest, c.destWidth, c.destHeight, static_cast<unsigned int>(c.destX),
+                                                      static_cast<unsigned int>(c.destY), src, c.srcWidth, c.srcHeight, c.op);
+                                          },
+                                          legacy, caseCount, seed));
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc > 1) caseCount = std::strtoul(argv[1], nullptr, 10);
+  if (argc > 2) seed = static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10));
+#if defined(__AVX2__) && BITBLIT_SIMD
+  const char *mode = "AVX2";
+#elif BITBLIT_SIMD
+  const char *mode = "SSE2";
+#else
+  const char *mode = "scalar";
+#endif
+  std::printf("bitblit differential run, %s row transfer, %zu cases per variant, seed %u\n", mode, caseCount, seed);
+  runTemplateVariants<uint8_t, uint8_t>("u8<u8");
+  runTemplateVariants<uint16_t, uint8_t>("u16<u8");
+  runTemplateVariants<uint32_t, uint8_t>("u32<u8");
+  runTemplateVariants<uint8_t, uint16_t>("u8<u16");
+  runTemplateVariants<uint32_t, uint16_t>("u32<u16");
+  runTemplateVariants<uint16_t, uint32_t>("u16<u32");
+  runPagedVariants<uint8_t>("u8<u8");
+  runPagedVariants<uint16_t>("u8<u16");
+  runFillVariants<uint8_t>("u8");
+  runFillVariants<uint16_t>("u16");
+  runFillVariants<uint32_t>("u32");
+  runPagedFillVariants();
+  runByteVariants();
+  std::printf("%zu variants mismatched\n", failedVariants);
+  return failedVariants == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,127 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (c) 2023 Bart Bilos
+ * For conditions of distribution and use, see LICENSE file
+ */
+/**
+ *\file sharp_memlcd_vcom.cpp
+ *
+ * Checks the VCOM inversion of the sharp memory LCD drivers with the mock transport
+ *
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <hardware_mocks.hpp>
+#include <sharp_memlcd.hpp>
+
+namespace {
+
+using lcdType = util::sharpMemLcd<util::LS013B7DH03>;
+using bandedType = util::sharpMemLcdBanded<util::LS013B7DH03, 16>;
+using mockType = util::hardware_mocks::transportMock<uint16_t, 4096, 64>;
+
+lcdType lcd;
+bandedType banded;
+util::displayList<4> list;
+mockType bus;
+int failures = 0;
+
+void check(bool condition, const char *description) {
+  if (condition) return;
+  std::printf("FAIL: %s\n", description);
+  failures++;
+}
+
+bool isVcomCommand(size_t transaction, uint16_t vcom) {
+  return (bus.transaction(transaction).size() == 1) && (bus.transaction(transaction)[0] == vcom);
+}
+
+void idleFlips() {
+  bus.initialize();
+  lcd.init();
+  lcd.lcdUpdate(bus);
+  lcd.flipVcom(bus);
+  lcd.flipVcom(bus);
+  check(bus.transactionCount == 3, "idle flips send a command each");
+  check(isVcomCommand(1, lcd.vcomBit) && isVcomCommand(2, 0), "idle flips alternate VCOM");
+}
+
+void dirtyFlipsWithoutUpdate() {
+  const size_t flips = 5;
+  bus.initialize();
+  lcd.init();
+  lcd.lcdUpdate(bus);
+  lcd.fillRect(0, 0, 10, 10, true);
+  for (size_t i = 0; i < flips; i++) lcd.flipVcom(bus);
+  // the first flip is owed to the update, every later flip sends the owed state
+  check(bus.transactionCount == flips, "dirty flips without update are not lost");
+  uint16_t expected = lcd.vcomBit;
+  for (size_t i = 1; i < bus.transactionCount; i++) {
+    check(isVcomCommand(i, expected), "owed VCOM states alternate");
+    expected = expected ^ lcd.vcomBit;
+  }
+  lcd.lcdUpdate(bus);
+  check((bus.transaction(bus.transactionCount - 1)[0] & lcd.vcomBit) == (flips % 2 == 0 ? 0 : lcd.vcomBit),
+        "update carries the owed VCOM state");
+  lcd.flipVcom(bus);
+  check(isVcomCommand(bus.transactionCount - 1, flips % 2 == 0 ? lcd.vcomBit : 0), "flip after the update is sent");
+}
+
+void flipFoldedIntoUpdate() {
+  bus.initialize();
+  lcd.init();
+  lcd.flipVcom(bus);
+  check(bus.transactionCount == 0, "flip with pending update is folded");
+  lcd.lcdUpdate(bus);
+  check((bus.transactionCount == 1) && ((bus.transaction(0)[0] & lcd.vcomBit) == lcd.vcomBit), "update carries VCOM");
+  lcd.flipVcom(bus);
+  check(isVcomCommand(1, 0), "flip after the update is sent");
+}
+
+auto mockFunction() {
+  return [](const uint16_t *begin, const uint16_t *end) {
+    const util::transferSegment<uint16_t> segments[] = {{begin, end}};
+    bus.transfer(segments);
+  };
+}
+
+void bandedDirtyFlipsWithoutUpdate() {
+  const size_t flips = 4;
+  bus.initialize();
+  banded.init();
+  list.reset();
+  list.fill(0, 0, 10, 10, util::bitblitOperation::OP_MOV);
+  banded.lcdUpdate(list, mockFunction());
+  const size_t bands = bus.transactionCount;
+  banded.flipVcom(mockFunction());
+  check(isVcomCommand(bands, banded.vcomBit), "banded idle flip is sent");
+  banded.updatePending = true;
+  for (size_t i = 0; i < flips; i++) banded.flipVcom(mockFunction());
+  check(bus.transactionCount == bands + flips, "banded dirty flips without update are not lost");
+  // the idle flip left VCOM at vcomBit, so the owed states start at 0
+  uint16_t expected = 0;
+  for (size_t i = bands + 1; i < bus.transactionCount; i++) {
+    check(isVcomCommand(i, expected), "banded owed VCOM states alternate");
+    expected = expected ^ banded.vcomBit;
+  }
+  const size_t first = bus.transactionCount;
+  banded.lcdUpdate(list, mockFunction());
+  const uint16_t vcom = (flips % 2 == 0) ? banded.vcomBit : 0;  // idle flip plus flips inversions
+  check(bus.transactionCount - first == bands, "banded update sends every band");
+  for (size_t i = first; i < bus.transactionCount; i++)
+    check((bus.transaction(i)[0] & banded.vcomBit) == vcom, "every band carries the owed VCOM state");
+  banded.flipVcom(mockFunction());
+  check(isVcomCommand(bus.transactionCount - 1, vcom ^ banded.vcomBit), "banded flip after the update is sent");
+}
+
+}  // namespace
+
+int main() {
+  idleFlips();
+  dirtyFlipsWithoutUpdate();
+  flipFoldedIntoUpdate();
+  bandedDirtyFlipsWithoutUpdate();
+  std::printf("sharp memory LCD VCOM: %d failures\n", failures);
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}